@@ -49,12 +49,15 @@ extern const CN_PROGMEM char CN_blanktime [];
 extern const CN_PROGMEM char CN_bridge [];
 extern const CN_PROGMEM char CN_brightness [];
 extern const CN_PROGMEM char CN_brightnessEnd [];
+extern const CN_PROGMEM char CN_capture [];
 extern const CN_PROGMEM char CN_cfgver [];
+extern const CN_PROGMEM char CN_channel_current [];
 extern const CN_PROGMEM char CN_channels [];
 extern const CN_PROGMEM char CN_clean [];
 extern const CN_PROGMEM char CN_clock_pin [];
 extern const CN_PROGMEM char CN_cmd [];
 extern const CN_PROGMEM char CN_color [];
+extern const CN_PROGMEM char CN_color_matrix [];
 extern const CN_PROGMEM char CN_color_order [];
 extern const CN_PROGMEM char CN_Configuration_File_colon [];
 extern const CN_PROGMEM char CN_config [];
@@ -69,12 +72,14 @@ extern const CN_PROGMEM char CN_device [];
 extern const CN_PROGMEM char CN_dhcp [];
 extern const CN_PROGMEM char CN_Default [];
 extern const CN_PROGMEM char CN_Disabled [];
+extern const CN_PROGMEM char CN_dither [];
 extern const CN_PROGMEM char CN_dnsp [];
 extern const CN_PROGMEM char CN_dnss [];
 extern const CN_PROGMEM char CN_Dotfseq [];
 extern const CN_PROGMEM char CN_Dotjson [];
 extern const CN_PROGMEM char CN_Dotpl [];
 extern const CN_PROGMEM char CN_DMX [];
+extern const CN_PROGMEM char CN_DoubleBuffer [];
 extern const CN_PROGMEM char CN_duration [];
 extern const CN_PROGMEM char CN_effect [];
 extern const CN_PROGMEM char CN_effect_list [];
@@ -103,6 +108,7 @@ extern const CN_PROGMEM char CN_file [];
 extern const CN_PROGMEM char CN_filename [];
 extern const CN_PROGMEM char CN_files [];
 extern const CN_PROGMEM char CN_FPPoverride [];
+extern const CN_PROGMEM char CN_FrameRate [];
 extern const CN_PROGMEM char CN_Frequency [];
 extern const CN_PROGMEM char CN_fseqfilelist [];
 extern const CN_PROGMEM char CN_fseqfilename [];
@@ -125,11 +131,14 @@ extern const CN_PROGMEM char CN_hv [];
 extern const CN_PROGMEM char CN_id [];
 extern const CN_PROGMEM char CN_Idle [];
 extern const CN_PROGMEM char CN_init [];
+extern const CN_PROGMEM char CN_input_16bit [];
 extern const CN_PROGMEM char CN_interframetime [];
+extern const CN_PROGMEM char CN_Interpolate [];
 extern const CN_PROGMEM char CN_inv [];
 extern const CN_PROGMEM char CN_ip [];
 extern const CN_PROGMEM char CN_input [];
 extern const CN_PROGMEM char CN_input_config [];
+extern const CN_PROGMEM char CN_KeepAliveMs [];
 extern const CN_PROGMEM char CN_last_clientIP [];
 extern const CN_PROGMEM char CN_long [];
 extern const CN_PROGMEM char CN_lwt [];
@@ -174,6 +183,7 @@ extern const CN_PROGMEM char CN_plussigns [];
 extern const CN_PROGMEM char CN_polarity [];
 extern const CN_PROGMEM char CN_PollCounter [];
 extern const CN_PROGMEM char CN_port [];
+extern const CN_PROGMEM char CN_power_limit [];
 extern const CN_PROGMEM char CN_power_pin [];
 extern const CN_PROGMEM char CN_prependnullcount [];
 extern const CN_PROGMEM char CN_pwm [];
@@ -191,6 +201,7 @@ extern const CN_PROGMEM char CN_sdspeed [];
 extern const CN_PROGMEM char CN_seconds_elapsed [];
 extern const CN_PROGMEM char CN_seconds_played [];
 extern const CN_PROGMEM char CN_seconds_remaining [];
+extern const CN_PROGMEM char CN_segments [];
 extern const CN_PROGMEM char CN_SendFppSync [];
 extern const CN_PROGMEM char CN_sensor [];
 extern const CN_PROGMEM char CN_sequence_filename [];
@@ -202,6 +213,7 @@ extern const CN_PROGMEM char CN_speed [];
 extern const CN_PROGMEM char CN_ssid [];
 extern const CN_PROGMEM char CN_sta_timeout [];
 extern const CN_PROGMEM char CN_stars [];
+extern const CN_PROGMEM char CN_start_channel [];
 extern const CN_PROGMEM char CN_state [];
 extern const CN_PROGMEM char CN_status [];
 extern const CN_PROGMEM char CN_status_name [];
@@ -238,6 +250,8 @@ extern const CN_PROGMEM char CN_user [];
 extern const CN_PROGMEM char CN_version [];
 extern const CN_PROGMEM char CN_Version [];
 extern const CN_PROGMEM char CN_weus [];
+extern const CN_PROGMEM char CN_white_extract [];
+extern const CN_PROGMEM char CN_white_point [];
 extern const CN_PROGMEM char CN_wifi [];
 extern const CN_PROGMEM char CN_WiFiDrv [];
 extern const CN_PROGMEM char CN_WS2801 [];
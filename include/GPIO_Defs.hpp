@@ -132,6 +132,8 @@ typedef enum
 #   include "platforms/GPIO_Defs_ESP32_TWILIGHTLORD.hpp"
 #elif defined (BOARD_ESP32_TWILIGHTLORD_ETH)
 #   include "platforms/GPIO_Defs_ESP32_TWILIGHTLORD_ETH.hpp"
+#elif defined (BOARD_ESP32_DEVKITC_I2S)
+#   include "platforms/GPIO_Defs_ESP32_DevkitC_I2S.hpp"
 #elif defined (BOARD_ESP32_DEVKITC)
 #   include "platforms/GPIO_Defs_ESP32_DevkitC.hpp"
 #elif defined (BOARD_ESP01S)
@@ -167,3 +169,8 @@ typedef enum
 #if defined(SUPPORT_SD) || defined(SUPPORT_SD_MMC)
 #   define SUPPORT_FPP
 #endif // defined(SUPPORT_SD) || defined(SUPPORT_SD_MMC)
+
+// A board enables the I2S parallel output by defining DEFAULT_I2S_0_GPIO ... DEFAULT_I2S_15_GPIO
+#if defined(DEFAULT_I2S_0_GPIO)
+#   define SUPPORT_I2S_OUTPUT
+#endif // defined(DEFAULT_I2S_0_GPIO)
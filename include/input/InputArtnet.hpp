@@ -26,7 +26,7 @@ class c_InputArtnet : public c_InputCommon
   private:
     static const uint16_t   UNIVERSE_MAX = 512;
     static const char       ConfigFileName[];
-    static const uint8_t    MAX_NUM_UNIVERSES = (OM_MAX_NUM_CHANNELS / UNIVERSE_MAX) + 1;
+    static const uint8_t    MAX_NUM_UNIVERSES = (OM_MAX_TOTAL_CHANNELS / UNIVERSE_MAX) + 1;
 
     char     _Artnet[sizeof(Artnet)];
     Artnet * pArtnet = nullptr;
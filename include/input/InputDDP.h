@@ -103,8 +103,8 @@ private:
     void NetworkStateChanged (bool NetwokState);
 
     // Packet parser callback
-    void ProcessReceivedUdpPacket (AsyncUDPPacket _packet);
-    void ProcessReceivedData  (DDP_packet_t & Packet);
+    void ProcessReceivedUdpPacket (AsyncUDPPacket & _packet);
+    void ProcessReceivedData  (DDP_Header_t & header, byte * Data, uint32_t DataLength);
     void ProcessReceivedQuery ();
 
     enum PacketBufferStatus_t
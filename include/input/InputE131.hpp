@@ -21,16 +21,42 @@
 #include "InputCommon.hpp"
 #include <ESPAsyncE131.h>
 
+#ifdef ESP32
+#include <AsyncUDP.h>
+#elif defined (ESP8266)
+#include <ESPAsyncUDP.h>
+#else
+#error Platform not supported
+#endif
+
 class c_InputE131 : public c_InputCommon
 {
   private:
     static const uint16_t   UNIVERSE_MAX = 512;
     static const char       ConfigFileName[];
-    static const uint8_t    MAX_NUM_UNIVERSES = (OM_MAX_NUM_CHANNELS / UNIVERSE_MAX) + 1;
+    static const uint8_t    MAX_NUM_UNIVERSES = (OM_MAX_TOTAL_CHANNELS / UNIVERSE_MAX) + 1;
+
+    // E1.31-2016 packet layout. The library does not pass sync packets on
+    // so the packets are received and checked here.
+    static const uint32_t   ACN_ID_OFFSET               = 4;
+    static const uint32_t   ACN_ID_LENGTH               = 12;
+    static const uint32_t   ROOT_VECTOR_OFFSET          = 18;
+    static const uint32_t   FRAME_VECTOR_OFFSET         = 40;
+    static const uint32_t   DATA_SYNC_ADDRESS_OFFSET    = 109;
+    static const uint32_t   DMP_VECTOR_OFFSET           = 117;
+    static const uint32_t   PROPERTY_VALUES_OFFSET      = 125;
+    static const uint32_t   DATA_PACKET_MIN_LENGTH      = PROPERTY_VALUES_OFFSET + 1;
+    static const uint32_t   SYNC_SYNC_ADDRESS_OFFSET    = 45;
+    static const uint32_t   SYNC_PACKET_LENGTH          = 49;
+    static const uint32_t   VECTOR_ROOT_E131_DATA       = 0x00000004;
+    static const uint32_t   VECTOR_ROOT_E131_EXTENDED   = 0x00000008;
+    static const uint32_t   VECTOR_E131_DATA_PACKET     = 0x00000002;
+    static const uint32_t   VECTOR_E131_EXTENDED_SYNC   = 0x00000001;
+    static const uint32_t   VECTOR_DMP_SET_PROPERTY     = 0x02;
+    static const uint32_t   SYNC_TIMEOUT_MS             = 2500; ///< E131_NETWORK_DATA_LOSS_TIMEOUT
 
-    byte _e131[sizeof(ESPAsyncE131)];
-    #define e131 static_cast<ESPAsyncE131>(*(&_e131[0]))
-    ESPAsyncE131 * pE131 = nullptr;
+    byte _udp[sizeof(AsyncUDP)];
+    AsyncUDP * pUdp = nullptr;
 
     // e131_packet_t packet;           ///< Packet buffer for parsing
 
@@ -40,7 +66,15 @@ class c_InputE131 : public c_InputCommon
     uint16_t    ChannelsPerUniverse        = 512;  ///< Universe boundary limit
     uint16_t    FirstUniverseChannelOffset = 1;    ///< Channel to start listening at - 1 based
     ESPAsyncE131PortId PortId              = E131_DEFAULT_PORT;
-    bool        ESPAsyncE131Initialized    = false;
+    bool        UdpInitialized             = false;
+
+    uint32_t    PacketCounter              = 0;
+    uint32_t    PacketErrorCounter         = 0;    ///< packets that are not valid E1.31
+    uint32_t    LastClientIP               = 0;
+
+    uint16_t    SyncUniverse               = 0;    ///< Sync address used by the sender. Zero if not synchronized
+    uint32_t    LastSyncPacketMS           = 0;
+    uint32_t    SyncPacketCounter          = 0;
 
     /// from sketch globals
     uint16_t    channel_count = 0;       ///< Number of channels. Derived from output module configuration.
@@ -58,6 +92,10 @@ class c_InputE131 : public c_InputCommon
     void validateConfiguration ();
     void NetworkStateChanged (bool IsConnected, bool RebootAllowed); // used by poorly designed rx functions
     void SetBufferTranslation ();
+    void ProcessReceivedUdpPacket (AsyncUDPPacket & ReceivedPacket);
+    void ProcessIncomingSyncPacket (e131_packet_t *);
+    void SetSyncUniverse (uint16_t NewSyncUniverse);
+    void JoinUniverseGroup (uint16_t Universe, bool Join);
 
   public:
 
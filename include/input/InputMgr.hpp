@@ -87,7 +87,8 @@ public:
     };
 
 private:
-    #define InputDriverMemorySize 2476
+    // the E1.31 and Artnet universe tables grow with the number of output channels
+    #define InputDriverMemorySize (2476 + ((((OM_MAX_TOTAL_CHANNELS - OM_MAX_NUM_CHANNELS) / 512) + 1) * 24))
 
     void InstantiateNewInputChannel (e_InputChannelIds InputChannelId, e_InputType NewChannelType, bool StartDriver = true);
     void CreateNewConfig ();
@@ -46,6 +46,7 @@ public:
     virtual uint32_t     Poll () = 0;                                        ///< Call from loop(),  renders output data
 #ifdef ARDUINO_ARCH_ESP32
     virtual bool         RmtPoll () = 0;                                        ///< Call from loop(),  renders output data
+    virtual bool         I2sPoll () { return false; }                          ///< The I2S engine is starting a frame. True if this output joins it
 #endif // def ARDUINO_ARCH_ESP32
     virtual void         GetDriverName (String & sDriverName) = 0;             ///< get the name for the instantiated driver
             OID_t        GetOutputChannelId () { return OutputChannelId; }     ///< return the output channel number
@@ -55,18 +56,33 @@ public:
             OTYPE_t      GetOutputType ()      { return OutputType; }          ///< Have the instance report its type.
     virtual void         GetStatus (ArduinoJson::JsonObject & jsonStatus) = 0;
     virtual void         BaseGetStatus (ArduinoJson::JsonObject & jsonStatus);
-            void         SetOutputBufferAddress (uint8_t* pNewOutputBuffer) { pOutputBuffer = pNewOutputBuffer; }
+            void         SetOutputBufferAddress (uint8_t* pNewOutputBuffer) { pOutputBuffer = pNewOutputBuffer; pBackBuffer = pNewOutputBuffer; }
+            void         SetBackBufferAddress (uint8_t* pNewBackBuffer) { pBackBuffer = pNewBackBuffer; } ///< Only differs from the output buffer when double buffering
+            void         SetFrontBufferAddress (uint8_t* pNewFrontBuffer) { pOutputBuffer = pNewFrontBuffer; } ///< Leaves the back buffer alone
+            uint8_t    * GetBackBufferAddress () { return pBackBuffer; }     ///< Where the inputs write their data
+            void         SetFrameBankAddress (uint32_t Bank, uint8_t * pBankBuffer) { pFrameBanks[Bank] = pBankBuffer; } ///< Where this output lives in each double buffer bank. nullptr if it does not latch banks
+    inline  void IRAM_ATTR ReleaseFrontBuffer () { OutputMgr.ReleaseFrameBank (LatchedFrameBank.exchange (OM_NO_FRAME_BANK)); } ///< Done reading the bank latched by LatchFrontBuffer
     virtual void         SetOutputBufferSize (uint32_t NewOutputBufferSize)  { OutputBufferSize = NewOutputBufferSize; };
     virtual uint32_t     GetNumOutputBufferBytesNeeded () = 0;
     virtual uint32_t     GetNumOutputBufferChannelsServiced () = 0;
-    virtual void         PauseOutput (bool NewState) {Paused = NewState;}
+    virtual void         PauseOutput (bool NewState) {Paused = NewState; MarkDirty ();}
     virtual void         WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
     virtual void         ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData);
+    virtual void         ClearBuffer () { memset (pBackBuffer, 0x00, OutputBufferSize); MarkDirty (); }
+            void         MarkDirty () { OutputBufferIsDirty = true; }            ///< The buffer has data that has not been sent
+            void         KickFrame () { FrameKicked = true; MarkDirty (); }     ///< An input committed a frame. Send it as soon as the output is free
+    virtual void         FrameCommitted (uint32_t /* PublishedBank */) {}      ///< The inputs are publishing the frame in the back buffer as this double buffer bank
+    virtual bool         IsIdentityMapped () { return true; }                  ///< true if WriteChannelData is a plain copy into the output buffer
+    virtual bool         CanInterpolate () { return false; }                   ///< true if every byte in the buffer is an 8 bit intensity
     virtual bool         ValidateGpio (gpio_num_t ConsoleTxGpio, gpio_num_t ConsoleRxGpio);
     virtual bool         DriverIsSendingIntensityData() {return false;}
     virtual uint32_t     GetFrameTimeMs() {return 1 + (ActualFrameDurationMicroSec / 1000); }
+            uint32_t     GetFrameCount () { return FrameCount; }               ///< Number of frames started since the last ClearStatistics
     bool                 IsPaused() {return Paused;}
     virtual void         ClearStatistics (void);
+            void         ReportFrameBuilt () { FrameBuiltTimeInMicroSec = micros (); } ///< frame data is ready and transmission is starting
+            void IRAM_ATTR ReportFrameSent ();                                   ///< the last bit of the frame is out. Safe to call from an ISR
+    inline  void IRAM_ATTR ReportIsrTime (uint32_t IsrMicroSec) { FrameIsrMicroSec += IsrMicroSec; }
 
 protected:
 
@@ -77,12 +93,41 @@ protected:
     bool        HasBeenInitialized          = false;
     uint32_t    FrameDurationInMicroSec     = 25000;
     uint32_t    ActualFrameDurationMicroSec = 50000; // Default time for relays is every 50ms
-    uint8_t   * pOutputBuffer               = nullptr;
+    uint8_t   * pOutputBuffer               = nullptr; ///< data being sent
+    uint8_t   * pBackBuffer                 = nullptr; ///< data being received. Same as pOutputBuffer unless double buffering
+    uint8_t   * pFrameBanks[OM_NUM_FRAME_BANKS] = { nullptr };
+    std::atomic<uint32_t> LatchedFrameBank  {OM_NO_FRAME_BANK}; ///< bank the frame being sent is read from
     uint32_t    OutputBufferSize            = 0;
     uint32_t    FrameCount                  = 0;
     bool        Paused = false;
+    volatile bool OutputBufferIsDirty       = true;
+    volatile bool FrameKicked               = false;
+
+    // frame scheduler statistics
+    uint32_t    LastFrameTick               = 0;
+    uint32_t    LastPollTick                = 0;    ///< tick seen by the last canRefresh
+    uint32_t    TickOffsetMicroSec          = 0;    ///< how long after the tick the last frame started
+    uint32_t    TickOffsetMaxMicroSec       = 0;
+    uint32_t    TickJitterMicroSec          = 0;    ///< smoothed variation of the tick offset
+
+    // frame timing history. Build, transmit and ISR times saturate at 65535 us
+#define OUTPUT_TIMING_HISTORY_SIZE 16
+    typedef struct FrameTiming_s
+    {
+        uint16_t BuildUs;       ///< frame start to data ready
+        uint16_t TransmitUs;    ///< data ready to the end of the frame
+        uint32_t GapUs;         ///< end of the previous frame to the start of this one. Idle outputs can wait seconds
+        uint16_t IsrUs;         ///< time spent in the driver ISR during this frame
+    } FrameTiming_t;
+    FrameTiming_t TimingHistory[OUTPUT_TIMING_HISTORY_SIZE];
+    uint32_t    TimingHistoryCount          = 0;    ///< total entries written. Next slot is Count % Size
+    uint32_t    MissedDeadlines             = 0;    ///< frames that took longer than the refresh period
+    uint32_t    FrameBuiltTimeInMicroSec    = 0;
+    uint32_t    LastFrameEndTimeInMicroSec  = 0;
+    volatile uint32_t FrameIsrMicroSec      = 0;
 
     virtual void ReportNewFrame ();
+            uint8_t * LatchFrontBuffer ();      ///< Start of a frame. Returns the data to send and holds it until ReleaseFrontBuffer
 
     inline bool canRefresh ()
     {
@@ -96,9 +141,36 @@ protected:
             FrameTimeDeltaInMicroSec = Now + (0 - FrameStartTimeInMicroSec);
         }
 
-        if(FrameTimeDeltaInMicroSec > FrameDurationInMicroSec)
+        // Nothing new to send? Only refresh often enough to keep the output alive
+        uint32_t KeepAliveMicroSec = OutputMgr.GetKeepAliveIntervalMicroSec ();
+        bool     WantsFrame        = OutputBufferIsDirty ||
+                                     (0 == KeepAliveMicroSec) ||
+                                     (FrameTimeDeltaInMicroSec > KeepAliveMicroSec);
+
+        uint32_t TickPeriodMicroSec = OutputMgr.GetFrameTickPeriodMicroSec ();
+        if (TickPeriodMicroSec)
+        {
+            // When the scheduler is running, frames only start on the first poll
+            // after a tick so all of the outputs stay in phase. The last frame
+            // has to be off the wire before the tick. An output that is still
+            // sending, or finishes part way through a tick, sits the tick out
+            // rather than starting late.
+            uint32_t Tick    = Now / TickPeriodMicroSec;
+            bool     NewTick = (Tick != LastPollTick);
+            LastPollTick     = Tick;
+
+            response = WantsFrame && NewTick &&
+                       (FrameTimeDeltaInMicroSec >= ActualFrameDurationMicroSec) &&
+                       ((LastFrameEndTimeInMicroSec / TickPeriodMicroSec) != Tick);
+        }
+        else if (FrameTimeDeltaInMicroSec > FrameDurationInMicroSec)
+        {
+            response = WantsFrame;
+        }
+        else if (FrameKicked)
         {
-            response = true;
+            // a committed frame only has to wait for the last one to be sent
+            response = (FrameTimeDeltaInMicroSec >= ActualFrameDurationMicroSec);
         }
         return response;
     }
@@ -0,0 +1,160 @@
+#pragma once
+/*
+* OutputFrameHandoff.hpp - Frame bank handoff between the inputs and the outputs
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2021, 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Single producer / single consumer handoff over four banks. The inputs
+*   fill the back bank and the last complete frame waits in the ready bank.
+*   The outputs start new frames from the front bank. The retired bank is the
+*   previous front bank, which drivers may still be sending from.
+*
+*   Publishing a frame swaps the back and ready banks. Taking a frame swaps
+*   the ready and retired banks, then the front bank becomes the retired
+*   bank. A frame is only taken once no driver holds the retired bank, so
+*   the inputs never get a bank that is still being sent. Drivers hold the
+*   front bank from the start of a frame (Latch) to its end (Release).
+*
+*   This file only uses <atomic> so the handoff can be stress tested on a
+*   host with threads.
+*
+*/
+#include <stdint.h>
+#include <atomic>
+
+#define FRAME_HANDOFF_NUM_BANKS         4
+#define FRAME_HANDOFF_NO_BANK           FRAME_HANDOFF_NUM_BANKS
+#define FRAME_HANDOFF_READY_MASK        0x3     // bank index
+#define FRAME_HANDOFF_READY_FRESH       0x4     // set by the inputs, cleared when the outputs take the frame
+#define FRAME_HANDOFF_SEQUENCE_SHIFT    3       // frame sequence number in the remaining bits
+
+#ifndef IRAM_ATTR
+#   define IRAM_ATTR
+#endif // ndef IRAM_ATTR
+
+class c_FrameHandoff
+{
+public:
+    /// Only call while no frame is being sent. Everything uses bank 0 when not double buffered
+    void Reset (bool DoubleBuffered)
+    {
+        BackBank    = DoubleBuffered ? 1 : 0;
+        RetiredBank = DoubleBuffered ? 3 : 0;
+        FrontBank.store (0);
+        ReadyBank.store (DoubleBuffered ? 2 : 0);
+        for (std::atomic<uint32_t> & Users : BankUsers)
+        {
+            Users.store (0);
+        }
+        PublishedSequence = 0;
+        FrontSequence     = 0;
+        DroppedFrames     = 0;
+        DeferredTakes     = 0;
+    }
+
+    /// Input side. Makes the back bank the latest complete frame and returns
+    /// its index. The bank that comes back from the exchange is either one the
+    /// outputs are done with or a frame they never got to.
+    uint32_t Publish ()
+    {
+        uint32_t PublishedBank = BackBank;
+        uint32_t Previous = ReadyBank.exchange ((++PublishedSequence << FRAME_HANDOFF_SEQUENCE_SHIFT) | FRAME_HANDOFF_READY_FRESH | PublishedBank,
+                                                std::memory_order_acq_rel);
+        if (Previous & FRAME_HANDOFF_READY_FRESH)
+        {
+            ++DroppedFrames;
+        }
+        BackBank = Previous & FRAME_HANDOFF_READY_MASK;
+        return PublishedBank;
+    }
+
+    /// Output side. True if the front bank now holds a new frame. A new frame
+    /// waits while a driver is still sending from the retired bank.
+    bool Take ()
+    {
+        bool Response = false;
+
+        do // once
+        {
+            if (0 == (ReadyBank.load (std::memory_order_acquire) & FRAME_HANDOFF_READY_FRESH))
+            {
+                break;
+            }
+
+            if (0 != BankUsers[RetiredBank].load ())
+            {
+                ++DeferredTakes;
+                break;
+            }
+
+            // only the inputs set the fresh flag so the frame we get back is still fresh
+            uint32_t Ready = ReadyBank.exchange (RetiredBank, std::memory_order_acq_rel);
+            RetiredBank    = FrontBank.load ();
+            FrontBank.store (Ready & FRAME_HANDOFF_READY_MASK);
+            FrontSequence  = Ready >> FRAME_HANDOFF_SEQUENCE_SHIFT;
+            Response = true;
+
+        } while (false);
+
+        return Response;
+    }
+
+    /// Driver side. Holds the front bank and returns its index. The outputs
+    /// can take a frame while we get hold of the bank so check that it is
+    /// still the front bank once it is held.
+    uint32_t Latch ()
+    {
+        uint32_t Bank = FrontBank.load ();
+        while (true)
+        {
+            BankUsers[Bank].fetch_add (1);
+            if (Bank == FrontBank.load ())
+            {
+                break;
+            }
+            BankUsers[Bank].fetch_sub (1);
+            Bank = FrontBank.load ();
+        }
+        return Bank;
+    }
+
+    /// Driver side. The frame sent from Bank is done. Safe to call from an ISR
+    inline void IRAM_ATTR Release (uint32_t Bank)
+    {
+        if (Bank < FRAME_HANDOFF_NUM_BANKS)
+        {
+            BankUsers[Bank].fetch_sub (1);
+        }
+    }
+
+    uint32_t GetFrontBank ()            { return FrontBank.load (std::memory_order_relaxed); }
+    uint32_t GetBackBank ()             { return BackBank; }
+    uint32_t GetPublishedSequence ()    { return PublishedSequence; }
+    uint32_t GetFrontSequence ()        { return FrontSequence; }
+    uint32_t GetDroppedFrames ()        { return DroppedFrames; }
+    uint32_t GetDeferredTakes ()        { return DeferredTakes; }
+
+private:
+    uint32_t              BackBank          = 0;    ///< only changed by the inputs
+    uint32_t              RetiredBank       = 0;    ///< only changed by the outputs
+    std::atomic<uint32_t> FrontBank         {0};    ///< only changed by the outputs. Read by the drivers
+    std::atomic<uint32_t> ReadyBank         {0};    ///< bank index, fresh flag and sequence number
+    std::atomic<uint32_t> BankUsers[FRAME_HANDOFF_NUM_BANKS] = {};  ///< drivers sending from each bank
+    uint32_t              PublishedSequence = 0;    ///< last frame published by the inputs
+    uint32_t              FrontSequence     = 0;    ///< frame the outputs are sending
+    uint32_t              DroppedFrames     = 0;    ///< published frames that were replaced before being sent
+    uint32_t              DeferredTakes     = 0;    ///< polls that found a new frame while the retired bank was still being sent
+
+}; // c_FrameHandoff
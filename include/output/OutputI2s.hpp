@@ -0,0 +1,107 @@
+#pragma once
+/*
+* OutputI2s.hpp - I2S parallel driver code for ESPixelStick
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2015, 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Drives up to 16 pixel strings at once from the I2S0 peripheral in LCD
+*   (parallel) mode. Each string is a lane. Lanes register with the shared
+*   engine and all lanes that are ready send their frames together. Frame
+*   data is encoded into two DMA buffers that are refilled from the DMA end
+*   of buffer interrupt, so RAM use does not depend on the pixel count.
+*
+*/
+
+#include "ESPixelStick.h"
+#if defined(SUPPORT_I2S_OUTPUT)
+
+#if !defined(CONFIG_IDF_TARGET_ESP32)
+#   error "The I2S parallel output requires an ESP32 (I2S LCD mode)"
+#endif // !defined(CONFIG_IDF_TARGET_ESP32)
+
+#include <rom/lldesc.h>
+#include <esp_intr_alloc.h>
+#include "OutputPixel.hpp"
+#include "OutputI2sEncoder.hpp"
+
+class c_OutputI2s
+{
+public:
+    c_OutputI2s ();
+    virtual ~c_OutputI2s ();
+
+    void RegisterLane       (uint32_t Lane, gpio_num_t DataPin, uint32_t InterFrameGapMicroSec, c_OutputPixel * pPixelDataSource, c_OutputCommon * pParent);
+    void UnregisterLane     (uint32_t Lane);
+    bool StartNewFrame      ();
+    void AbortFrame         ();                         ///< Give up on a frame whose end of frame interrupt never came
+    void GetStatus          (ArduinoJson::JsonObject & jsonStatus);
+    bool FrameIsInProgress  () { return FrameInProgress; }
+
+    void IRAM_ATTR ISR_Handler ();
+
+private:
+#define I2S_INTENSITIES_PER_BUFFER  32
+#define I2S_WORDS_PER_BUFFER        (I2S_INTENSITIES_PER_BUFFER * I2S_WORDS_PER_INTENSITY)
+#define I2S_NUM_DMA_BUFFERS         2
+#define I2S_LCD_BASE_CLOCK_HZ       80000000
+#define I2S_SLOT_RATE_HZ            (800000 * I2S_SLOTS_PER_BIT)
+#define I2S_BUFFER_TIME_US          ((I2S_INTENSITIES_PER_BUFFER * 8 * 1000000) / 800000)
+    // in 16 bit LCD mode the lanes come out on data signals 8 - 23
+#define I2S_FIRST_LANE_SIGNAL       (I2S0O_DATA_OUT0_IDX + 8)
+
+    struct Lane_t
+    {
+        c_OutputPixel  * pPixelDataSource  = nullptr;
+        c_OutputCommon * pParent           = nullptr;
+        gpio_num_t       DataPin           = gpio_num_t(-1);
+        uint32_t         InterFrameGapMicroSec = 0;
+    };
+
+    void Begin ();
+    void UpdateIdleBuffersNeeded ();
+    void IRAM_ATTR ISR_FillBuffer (uint32_t BufferId);
+    void IRAM_ATTR ISR_EndFrame ();
+
+    Lane_t              Lanes[I2S_MAX_LANES];
+    uint16_t            RegisteredLanes         = 0;
+    uint16_t            FrameLanes              = 0;    ///< lanes sending in the current frame
+    volatile bool       FrameInProgress         = false;
+    bool                HasBeenInitialized      = false;
+
+    lldesc_t            DmaDescriptors[I2S_NUM_DMA_BUFFERS];
+    uint16_t          * pDmaBuffers[I2S_NUM_DMA_BUFFERS] = { nullptr };
+    bool                BufferIsIdle[I2S_NUM_DMA_BUFFERS] = { false };
+    uint32_t            NumIdleBuffersSent      = 0;
+    uint32_t            NumIdleBuffersNeeded    = 1;
+
+    // staging for one buffer worth of intensities. Indexed [intensity][lane]
+    uint8_t             LaneData[I2S_INTENSITIES_PER_BUFFER][I2S_MAX_LANES];
+    uint16_t            ActiveLanes[I2S_INTENSITIES_PER_BUFFER];
+    uint32_t            IntensityValues[I2S_INTENSITIES_PER_BUFFER];
+
+    intr_handle_t       IsrHandle               = nullptr;
+
+    uint32_t            FrameCount              = 0;
+    uint32_t            FrameKickoffMicroSec    = 0;
+    uint32_t            FrameLatencyMicroSec    = 0;
+    uint32_t            MaxFrameLatencyMicroSec = 0;
+    uint32_t            DescriptorErrors        = 0;
+    uint32_t            FrameTimeouts           = 0;    ///< frames abandoned by the send task
+
+}; // c_OutputI2s
+
+extern c_OutputI2s OutputI2s;
+
+#endif // defined(SUPPORT_I2S_OUTPUT)
@@ -0,0 +1,96 @@
+#pragma once
+/*
+* OutputI2sEncoder.hpp - Bit transpose encoder for the I2S parallel output
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2015, 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   The I2S peripheral sends one 16 bit word per slot. Bit N of each word
+*   drives lane N. Every WS2811 bit takes four slots of 312.5ns:
+*
+*       zero bit:  1 0 0 0  (312ns high, 937ns low)
+*       one bit:   1 1 1 0  (937ns high, 312ns low)
+*
+*   This file has no platform dependencies so it can be built and checked
+*   on a host against known input / output vectors.
+*
+*/
+#include <stdint.h>
+
+#define I2S_MAX_LANES               16
+#define I2S_SLOTS_PER_BIT           4
+#define I2S_WORDS_PER_INTENSITY     (8 * I2S_SLOTS_PER_BIT)
+
+#ifndef IRAM_ATTR
+#   define IRAM_ATTR
+#endif // ndef IRAM_ATTR
+
+//----------------------------------------------------------------------------
+// Transpose an 8x8 bit matrix. Row i of the input is the intensity for lane i.
+// Row b of the output holds bit (7 - b) of every lane with lane i in bit i, so
+// Rows[0] is the MSB of all eight lanes.
+inline void IRAM_ATTR I2sTranspose8 (const uint8_t * pLaneBytes, uint8_t * pRows)
+{
+    // lane 7 goes in the top byte so that it ends up in bit 7 of each row
+    uint32_t x = (uint32_t (pLaneBytes[7]) << 24) | (uint32_t (pLaneBytes[6]) << 16) |
+                 (uint32_t (pLaneBytes[5]) <<  8) |  uint32_t (pLaneBytes[4]);
+    uint32_t y = (uint32_t (pLaneBytes[3]) << 24) | (uint32_t (pLaneBytes[2]) << 16) |
+                 (uint32_t (pLaneBytes[1]) <<  8) |  uint32_t (pLaneBytes[0]);
+    uint32_t t;
+
+    // swap 1x1, 2x2 and then 4x4 blocks (Hacker's Delight, transpose8rS32)
+    t = (x ^ (x >>  7)) & 0x00AA00AA;  x = x ^ t ^ (t <<  7);
+    t = (y ^ (y >>  7)) & 0x00AA00AA;  y = y ^ t ^ (t <<  7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;  x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;  y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    pRows[0] = uint8_t (x >> 24);
+    pRows[1] = uint8_t (x >> 16);
+    pRows[2] = uint8_t (x >>  8);
+    pRows[3] = uint8_t (x);
+    pRows[4] = uint8_t (y >> 24);
+    pRows[5] = uint8_t (y >> 16);
+    pRows[6] = uint8_t (y >>  8);
+    pRows[7] = uint8_t (y);
+} // I2sTranspose8
+
+//----------------------------------------------------------------------------
+// Encode one intensity for each of the 16 lanes into I2S_WORDS_PER_INTENSITY
+// words, MSB first. Lanes that are not set in ActiveLanes stay low.
+// In 16 bit mode the I2S FIFO sends the two halves of each 32 bit word in
+// swapped order. SwapWordPairs stores the words pre-swapped to undo that.
+inline void IRAM_ATTR I2sEncodeWS2811 (const uint8_t * pLaneBytes, uint16_t ActiveLanes, uint16_t * pWords, bool SwapWordPairs)
+{
+    uint8_t LowRows[8];
+    uint8_t HighRows[8];
+    I2sTranspose8 (&pLaneBytes[0], LowRows);
+    I2sTranspose8 (&pLaneBytes[8], HighRows);
+
+    uint32_t Swap = SwapWordPairs ? 1 : 0;
+
+    for (uint32_t Bit = 0; Bit < 8; ++Bit)
+    {
+        uint16_t Data = uint16_t ((uint16_t (HighRows[Bit]) << 8) | LowRows[Bit]) & ActiveLanes;
+        uint32_t Slot = Bit * I2S_SLOTS_PER_BIT;
+
+        pWords[(Slot + 0) ^ Swap] = ActiveLanes;
+        pWords[(Slot + 1) ^ Swap] = Data;
+        pWords[(Slot + 2) ^ Swap] = Data;
+        pWords[(Slot + 3) ^ Swap] = 0;
+    }
+} // I2sEncodeWS2811
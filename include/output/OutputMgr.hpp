@@ -25,6 +25,7 @@
 #include "ESPixelStick.h"
 #include "memdebug.h"
 #include "FileMgr.hpp"
+#include "output/OutputFrameHandoff.hpp"
 #include <TimeLib.h>
 
 class c_OutputCommon; ///< forward declaration to the pure virtual output class that will be defined later.
@@ -54,15 +55,25 @@ public:
     uint8_t*  GetBufferAddress  () { return OutputBuffer; } ///< Get the address of the buffer into which the E1.31 handler will stuff data
     uint32_t  GetBufferUsedSize () { return UsedBufferSize; } ///< Get the size (in intensities) of the buffer into which the E1.31 handler will stuff data
     uint32_t  GetBufferSize     () { return sizeof(OutputBuffer); } ///< Get the size (in intensities) of the buffer into which the E1.31 handler will stuff data
+    uint32_t  ReadOutputBuffer  (uint32_t Offset, uint32_t Count, uint8_t * pTarget); ///< Copy the data currently being sent. Offset is relative to the start of the used buffer space
+    uint32_t  GetKeepAliveIntervalMicroSec () { return KeepAliveIntervalMs * 1000; } ///< How often an output with no new data gets refreshed. Zero means every frame
+    uint32_t  GetFrameTickPeriodMicroSec () { return FrameTickPeriodMicroSec; } ///< Time between synchronized frame starts. Zero means each output runs free
     void      DeleteConfig      () { FileMgr.DeleteFlashFile (ConfigFileName); }
     void      PauseOutputs      (bool NewState);
     void      GetDriverName     (String & Name) { Name = "OutputMgr"; }
     void      WriteChannelData  (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t * pData);
     void      ReadChannelData   (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t *pTargetData);
     void      ClearBuffer       ();
+    void      CommitFrame       ();                        ///< Input has completed a frame. Send it on the next output frame
+    bool      FramesAreStaged   () { return IsDoubleBuffered (); } ///< True when data written before CommitFrame is held back until the commit
+    uint32_t  LatchFrameBank    () { return FrameHandoff.Latch (); } ///< Driver is starting a frame. Holds the front bank until ReleaseFrameBank
+    inline void IRAM_ATTR ReleaseFrameBank (uint32_t Bank) { FrameHandoff.Release (Bank); } ///< Driver has sent the frame it latched
     void      TaskPoll          ();
     void      RelayUpdate       (uint8_t RelayId, String & NewValue, String & Response);
     void      ClearStatistics   (void);
+    void      StartCapture      (const String & FileName, uint32_t NumFrames); ///< Record the next NumFrames transmitted frames to SD (or LittleFS)
+    void      StartReplay       (const String & FileName); ///< Send a recorded capture to the drivers in place of the input data
+    void      StopCapture       ();                        ///< End a capture or replay
 
     // handles to determine which output channel we are dealing with
     enum e_OutputChannelIds
@@ -111,6 +122,70 @@ public:
         OutputChannelId_RMT_7,
         #endif // def DEFAULT_RMT_3_GPIO
 
+        #ifdef DEFAULT_I2S_0_GPIO
+        OutputChannelId_I2S_0,
+        #endif // def DEFAULT_I2S_0_GPIO
+
+        #ifdef DEFAULT_I2S_1_GPIO
+        OutputChannelId_I2S_1,
+        #endif // def DEFAULT_I2S_1_GPIO
+
+        #ifdef DEFAULT_I2S_2_GPIO
+        OutputChannelId_I2S_2,
+        #endif // def DEFAULT_I2S_2_GPIO
+
+        #ifdef DEFAULT_I2S_3_GPIO
+        OutputChannelId_I2S_3,
+        #endif // def DEFAULT_I2S_3_GPIO
+
+        #ifdef DEFAULT_I2S_4_GPIO
+        OutputChannelId_I2S_4,
+        #endif // def DEFAULT_I2S_4_GPIO
+
+        #ifdef DEFAULT_I2S_5_GPIO
+        OutputChannelId_I2S_5,
+        #endif // def DEFAULT_I2S_5_GPIO
+
+        #ifdef DEFAULT_I2S_6_GPIO
+        OutputChannelId_I2S_6,
+        #endif // def DEFAULT_I2S_6_GPIO
+
+        #ifdef DEFAULT_I2S_7_GPIO
+        OutputChannelId_I2S_7,
+        #endif // def DEFAULT_I2S_7_GPIO
+
+        #ifdef DEFAULT_I2S_8_GPIO
+        OutputChannelId_I2S_8,
+        #endif // def DEFAULT_I2S_8_GPIO
+
+        #ifdef DEFAULT_I2S_9_GPIO
+        OutputChannelId_I2S_9,
+        #endif // def DEFAULT_I2S_9_GPIO
+
+        #ifdef DEFAULT_I2S_10_GPIO
+        OutputChannelId_I2S_10,
+        #endif // def DEFAULT_I2S_10_GPIO
+
+        #ifdef DEFAULT_I2S_11_GPIO
+        OutputChannelId_I2S_11,
+        #endif // def DEFAULT_I2S_11_GPIO
+
+        #ifdef DEFAULT_I2S_12_GPIO
+        OutputChannelId_I2S_12,
+        #endif // def DEFAULT_I2S_12_GPIO
+
+        #ifdef DEFAULT_I2S_13_GPIO
+        OutputChannelId_I2S_13,
+        #endif // def DEFAULT_I2S_13_GPIO
+
+        #ifdef DEFAULT_I2S_14_GPIO
+        OutputChannelId_I2S_14,
+        #endif // def DEFAULT_I2S_14_GPIO
+
+        #ifdef DEFAULT_I2S_15_GPIO
+        OutputChannelId_I2S_15,
+        #endif // def DEFAULT_I2S_15_GPIO
+
         #ifdef SUPPORT_SPI_OUTPUT
         OutputChannelId_SPI_1,
         #endif // def SUPPORT_SPI_OUTPUT
@@ -195,8 +270,10 @@ public:
 
 #ifdef ARDUINO_ARCH_ESP8266
 #   define OM_MAX_NUM_CHANNELS  (1200 * 3)
+#   define OM_MAX_TOTAL_CHANNELS (OM_MAX_NUM_CHANNELS * 2)
 #else // ARDUINO_ARCH_ESP32
 #   define OM_MAX_NUM_CHANNELS  (3000 * 3)
+#   define OM_MAX_TOTAL_CHANNELS (OM_MAX_NUM_CHANNELS * 2)
 #endif // !def ARDUINO_ARCH_ESP32
 
     enum OM_PortType_t
@@ -205,13 +282,16 @@ public:
         Rmt,
         Spi,
         Relay,
+        I2s,
         Undefined
     };
 
     // must be 16 byte aligned. Determined by upshifting the max size of all drivers
-    #define OutputDriverMemorySize 1200
+    #define OutputDriverMemorySize 1728
     uint32_t GetDriverSize() {return OutputDriverMemorySize;}
 private:
+    friend class c_OutputMgrTest;   ///< the host unit tests place outputs without the driver factory
+
     struct DriverInfo_t
     {
         alignas(16) byte    OutputDriver[OutputDriverMemorySize];
@@ -222,6 +302,10 @@ private:
         uint32_t            OutputChannelStartingOffset = 0;
         uint32_t            OutputChannelSize           = 0;
         uint32_t            OutputChannelEndOffset      = 0;
+        bool                IdentityMapped              = false;
+        bool                InOverflowBuffer            = false;
+        bool                Interpolated                = false;    ///< sent from the interpolation buffer
+        uint32_t            PhysicalBufferOffset        = 0;    ///< offset into the internal or overflow buffer
 
         gpio_num_t          GpioPin                     = gpio_num_t(-1);
         OM_PortType_t       PortType                    = OM_PortType_t::Undefined;
@@ -251,8 +335,152 @@ private:
 
     String ConfigFileName;
 
+    // Outputs that do not fit in the internal buffer are placed in an overflow
+    // buffer that is sized to fit. It comes from PSRAM if only relays use it.
     uint8_t    OutputBuffer[OM_MAX_NUM_CHANNELS];
-    uint32_t   UsedBufferSize = 0;
+    uint32_t   UsedBufferSize           = 0;
+    uint32_t   UsedInternalBufferSize   = 0;
+    uint32_t   OverflowBufferSize       = 0;
+
+    /*
+    *   Double buffering is a single producer / single consumer frame handoff
+    *   over four banks (see c_FrameHandoff). The inputs fill the back bank,
+    *   the outputs start new frames from the front bank and the last complete
+    *   frame waits in the ready bank. The fourth bank is the previous front
+    *   bank, which a driver may still be sending from. Drivers latch the
+    *   front bank when they start a frame and release it when the frame has
+    *   been sent, and a new frame is only taken once the retired bank has been
+    *   released, so the inputs never write into a bank that is on the wire.
+    *   When the inputs publish faster than the outputs send, the frame
+    *   waiting in the ready bank is replaced and counted as dropped.
+    */
+    #define OM_FRAME_COMMIT_TIMEOUT_MS  500
+    #define OM_NUM_FRAME_BANKS          FRAME_HANDOFF_NUM_BANKS
+    #define OM_NO_FRAME_BANK            FRAME_HANDOFF_NO_BANK
+    bool       DoubleBufferEnabled      = false;
+    uint8_t  * pInternalBank[OM_NUM_FRAME_BANKS] = {OutputBuffer, OutputBuffer, OutputBuffer, OutputBuffer};
+    uint8_t  * pOverflowBank[OM_NUM_FRAME_BANKS] = {nullptr, nullptr, nullptr, nullptr};
+    c_FrameHandoff FrameHandoff;
+    volatile uint32_t LastFrameCommitMS = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+    SemaphoreHandle_t PublishFrameLock  = NULL; ///< frames are published from the network task and from the main loop
+#endif // defined(ARDUINO_ARCH_ESP32)
+
+    bool IsDoubleBuffered () { return pInternalBank[0] != pInternalBank[1]; }
+    void UpdateDoubleBuffer ();
+    void ResetFrameHandoff ();
+    bool UpdateOverflowBuffer (uint32_t NewSize, bool NeedsInternalRam);
+    void FreeOverflowBuffer ();
+    void SetDriverBufferAddresses (DriverInfo_t & CurrentOutput);
+    void PublishFrame ();                       ///< input side. Make the back bank the latest complete frame
+    bool TakeFrame ();                          ///< output side. Start sending the latest complete frame if there is a new one
+    uint8_t * GetFrontBufferAddress (DriverInfo_t & CurrentOutput);
+
+    // interpolation. Blends from what was being sent to the latest frame over the output refreshes in between
+    #define OM_INTERPOLATION_STEPS      256
+    #define OM_INTERPOLATION_MAX_MS     250     // longer gaps between input frames are not blended over
+    bool       InterpolationEnabled     = false;
+    uint8_t  * pInterpolationFrom       = nullptr;  ///< what was being sent when the latest frame arrived
+    uint8_t  * pInterpolationOutput     = nullptr;  ///< what the interpolated outputs send from
+    uint32_t   InterpolationStep        = OM_INTERPOLATION_STEPS;
+    uint32_t   InterpolationStartUs     = 0;
+    uint32_t   InterpolationDurationUs  = 0;
+    uint32_t   InterpolationPeriodUs    = 0;        ///< how often a new blend is calculated
+    uint32_t   InterpolationLastUs      = 0;
+    uint32_t   LastFrameTakenUs         = 0;
+
+    void UpdateInterpolation ();
+    void StartInterpolation ();
+    void Interpolate ();
+    uint32_t WriteOutputBuffer (uint32_t Offset, uint32_t Count, uint8_t * pSource); ///< inverse of ReadOutputBuffer. Writes to the back bank
+
+    /*
+    *   Frame capture file. All values are little endian.
+    *
+    *   CaptureHeader_t
+    *   CaptureOutputInfo_t[NumOutputs]  where each output lives in the frame and
+    *                                    which input channels it was fed from
+    *   NumFrames records of:
+    *       uint32_t TimeOffsetMs        from the start of the capture
+    *       uint8_t  Data[FrameSize]     the output buffer in ReadOutputBuffer order
+    *
+    *   The data is what the drivers transmit from: after gamma, color order and
+    *   remapping. Only the power limit and the protocol framing are added later.
+    */
+    #define OM_CAPTURE_MAGIC            0x43505345  // "ESPC"
+    #define OM_CAPTURE_VERSION          1
+    #define OM_CAPTURE_BUFFER_SIZE      8192        // frames are written to the file in blocks of about this size
+    struct __attribute__((packed)) CaptureHeader_t
+    {
+        uint32_t Magic;
+        uint16_t Version;
+        uint16_t HeaderSize;        ///< offset to the first frame record
+        uint32_t FrameSize;
+        uint32_t NumFrames;
+        uint32_t NumOutputs;
+    };
+    struct __attribute__((packed)) CaptureOutputInfo_t
+    {
+        uint8_t  OutputType;        ///< e_OutputType
+        uint8_t  OutputChannelId;   ///< e_OutputChannelIds
+        uint16_t Reserved;
+        uint32_t BufferOffset;      ///< offset of this output within each frame
+        uint32_t BufferSize;
+        uint32_t ChannelOffset;     ///< first input channel sent to this output
+        uint32_t ChannelCount;
+    };
+    enum CaptureState_t
+    {
+        CaptureIdle = 0,
+        CaptureRecording,
+        CaptureReplaying,
+    };
+    enum CaptureRequest_t
+    {
+        CaptureRequestNone = 0,
+        CaptureRequestRecord,
+        CaptureRequestReplay,
+        CaptureRequestStop,
+    };
+    volatile CaptureRequest_t CaptureRequest = CaptureRequestNone;  ///< set by the web server, acted on by Poll
+    String     CaptureRequestFileName;
+    uint32_t   CaptureRequestNumFrames  = 0;
+    CaptureState_t CaptureState         = CaptureIdle;
+    String     CaptureFileName;
+    bool       CaptureOnSd              = false;
+    c_FileMgr::FileId CaptureSdFile     = c_FileMgr::INVALID_FILE_HANDLE;
+    fs::File   CaptureFlashFile;
+    uint8_t  * pCaptureBuffer           = nullptr;
+    uint32_t   CaptureBufferSize        = 0;
+    uint32_t   CaptureBufferUsed        = 0;
+    uint32_t   CaptureFrameSize         = 0;
+    uint32_t   CaptureHeaderSize        = 0;
+    uint32_t   CaptureNumFrames         = 0;    ///< frames to record or frames in the file being replayed
+    uint32_t   CaptureFrameCount        = 0;    ///< frames recorded or replayed so far
+    uint32_t   CaptureLastDriverFrames  = 0;
+    uint32_t   CaptureStartMs           = 0;
+    uint32_t   CaptureFilePosition      = 0;
+
+    void ProcessCapture ();
+    bool OpenCapture (bool ForWriting);
+    void CloseCapture ();
+    void CloseCaptureFile ();
+    bool WriteCaptureData (uint8_t * pData, uint32_t Length);
+    bool ReadCaptureData (uint32_t Position, uint8_t * pData, uint32_t Length);
+    bool BeginRecording ();
+    bool BeginReplay ();
+    bool FlushCaptureBuffer ();
+    bool ReadReplayFrame ();
+    uint32_t GetDriverFrameCount ();
+
+    // outputs with no new data are only refreshed this often. Zero refreshes every frame
+    #define OM_DEFAULT_KEEP_ALIVE_MS    0
+    uint32_t   KeepAliveIntervalMs      = OM_DEFAULT_KEEP_ALIVE_MS;
+
+    // frame scheduler. All outputs start their frames on a common tick
+    #define OM_MAX_FRAME_RATE           1000
+    uint32_t   FrameRate                = 0;    ///< frames per second. Zero disables the scheduler
+    uint32_t   FrameTickPeriodMicroSec  = 0;
     gpio_num_t ConsoleTxGpio  = gpio_num_t::GPIO_NUM_1;
     gpio_num_t ConsoleRxGpio  = gpio_num_t::GPIO_NUM_3;
 
@@ -263,6 +491,7 @@ private:
 
 #define OM_IS_UART (CurrentOutput.PortType == OM_PortType_t::Uart)
 #define OM_IS_RMT  (CurrentOutput.PortType == OM_PortType_t::Rmt)
+#define OM_IS_I2S  (CurrentOutput.PortType == OM_PortType_t::I2s)
 
 }; // c_OutputMgr
 
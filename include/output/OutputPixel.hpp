@@ -68,6 +68,10 @@ private:
 
     uint32_t    zig_size                    = 1;
 
+    uint16_t  * pPixelRemapTable            = nullptr;  ///< input pixel id to output pixel id (zig zag)
+    uint32_t    PixelRemapTableSize         = 0;
+    uint32_t    PixelStride                 = PIXEL_DEFAULT_INTENSITY_BYTES_PER_PIXEL; ///< bytes between two input pixels in the buffer
+
     uint32_t    PrependNullPixelCount       = 0;
     uint32_t    PrependNullPixelCurrentCount = 0;
 
@@ -75,8 +79,31 @@ private:
     uint32_t    AppendNullPixelCurrentCount = 0;
 
     bool        InvertData                  = false;
+    uint32_t    InvertMask                  = 0;
     uint32_t    IntensityMultiplier         = 1;
 
+    uint32_t    BytesPerIntensity           = 1;        ///< 2 for outputs that send 16 bit intensities
+    bool        Input16Bit                  = false;    ///< input sends each intensity as a high / low channel pair
+    uint32_t    InputBytesPerIntensity      = 1;
+    uint8_t     PartialIntensityHighByte    = 0;        ///< 16 bit input intensity that continues in the next write
+    uint32_t    PartialIntensityChannelId   = uint32_t (-1);
+    uint16_t  * pGammaTable16               = nullptr;  ///< 257 entry gamma / brightness curve for 16 bit outputs (not inverted)
+
+    bool        Dither                      = false;
+    uint16_t  * pDitherTable                = nullptr;  ///< input value to 8.8 fixed point intensity (not inverted)
+    uint8_t   * pDitherResidue              = nullptr;  ///< fraction carried to the next frame. One per output buffer byte
+
+    // power limiter
+#define PIXEL_POWER_SCALE_NONE 256
+    uint32_t    PowerLimitMa                = 0;        ///< zero disables the limiter
+    float       ChannelCurrentMa            = 20.0;     ///< current used by one color at full intensity
+    uint32_t    CurrentPerIntensityQ16      = 0;        ///< ChannelCurrentMa / 255 in 16.16 fixed point
+    uint32_t    IntensitySum                = 0;        ///< sum of the (high byte) intensities in the back buffer
+    uint32_t    BankIntensitySum[OM_NUM_FRAME_BANKS] = {0}; ///< sum of the intensities in each double buffer bank
+    uint32_t    EstimatedCurrentMa          = 0;        ///< for the frame being sent
+    uint32_t    PowerScale                  = PIXEL_POWER_SCALE_NONE; ///< applied to every intensity sent. 256 is full scale
+    uint32_t    PowerInvertMask             = 0;        ///< InvertMask limited to one intensity
+
 // #define USE_PIXEL_DEBUG_COUNTERS
 #ifdef USE_PIXEL_DEBUG_COUNTERS
     uint32_t   PixelsToSend                        = 0;
@@ -129,7 +156,49 @@ private:
     } ColorOffsets_t;
     ColorOffsets_t  ColorOffsets;
 
-    uint8_t     gamma_table[256]    = { 0 };    ///< Gamma Adjustment table
+    // Virtual segments. Several logical strings sharing one physical output.
+    // Segments are placed on the string in the order they are configured.
+#define PIXEL_MAX_SEGMENTS 8
+    typedef struct Segment_s
+    {
+        uint32_t        StartChannel;       ///< first input channel used by the segment. Relative to the start of this output
+        uint32_t        PixelCount;         ///< physical pixels in the segment
+        uint32_t        GroupSize;
+        bool            Reverse;
+        float           Gamma;
+        char            ColorOrder[10];
+        ColorOffsets_t  ColorOffsets;
+        uint8_t         GammaTable[256];    ///< same as gamma_table using the segment gamma
+    } Segment_t;
+    Segment_t * pSegments                   = nullptr;
+    uint32_t    NumSegments                 = 0;
+
+    typedef struct SegmentMapEntry_s
+    {
+        uint16_t    IntensityOffset;    ///< first intensity in the output buffer that gets this input channel
+        uint8_t     SegmentId;
+        uint8_t     GroupCount;         ///< number of pixels that get the value. Zero when no segment uses the channel
+    } SegmentMapEntry_t;
+    SegmentMapEntry_t * pSegmentMap         = nullptr;  ///< one entry per input intensity
+    uint32_t    SegmentMapSize              = 0;
+
+    // Color correction. Only allocated when the output uses it.
+#define PIXEL_COLOR_CORRECTION_BATCH_SIZE 32
+    typedef struct ColorCorrection_s
+    {
+        float       Matrix[9];          ///< 3x3 RGB correction. Row major
+        int16_t     MatrixQ8[9];        ///< Matrix in 8.8 fixed point
+        bool        MatrixIsIdentity;
+        bool        WhiteExtract;       ///< derive W from RGB input
+        uint8_t     WhitePoint[3];      ///< RGB equivalent of the white LED
+        uint16_t    WhiteScale[3];      ///< 65280 / WhitePoint
+        uint8_t     PartialPixel[4];    ///< start of a pixel that continues in the next write
+        uint32_t    PartialPixelId;
+    } ColorCorrection_t;
+    ColorCorrection_t * pColorCorrection    = nullptr;
+    uint32_t    NumInputChannelsPerPixel    = PIXEL_DEFAULT_INTENSITY_BYTES_PER_PIXEL; ///< 3 when W is extracted from RGB
+
+    uint8_t     gamma_table[256]    = { 0 };    ///< Gamma, brightness and inversion lookup table
     float       gamma               = 1.0;      ///< gamma value to use
     uint8_t     brightness          = 100;
     uint32_t    AdjustedBrightness  = 256;
@@ -141,10 +210,47 @@ private:
 
     // Internal variables
 
-    void updateGammaTable(); ///< Generate gamma correction table
+    void updateGammaTable(); ///< Generate the combined gamma / brightness / inversion table
     void updateColorOrderOffsets(); ///< Update color order
+    void updatePixelRemapTable();   ///< Precalculate the input pixel to buffer mapping
+    void updateDitherTables();      ///< Allocate and fill the temporal dithering tables
+    void updateIntensityWidth();    ///< Set up the 16 bit tables and buffer layout
+    void updateSegmentMap();        ///< Precalculate the input channel to buffer mapping for the virtual segments
+    void FillGammaTable(uint8_t * pTable, float Gamma);
+    static bool GetColorOrderOffsets(String ColorOrder, ColorOffsets_t & Offsets, uint32_t & NumBytes);
+    void SetSegmentConfig (ArduinoJson::JsonObject & jsonConfig);
+    void GetSegmentConfig (ArduinoJson::JsonObject & jsonConfig);
+    void WriteSegmentData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
+    void SetColorCorrectionConfig (ArduinoJson::JsonObject & jsonConfig);
+    void GetColorCorrectionConfig (ArduinoJson::JsonObject & jsonConfig);
+    void updateColorCorrection ();  ///< Precalculate the fixed point color correction values
+    void WriteColorCorrectedData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
+    void WriteIntensityData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
+    inline void ColorCorrectPixel (const uint8_t * pInput, uint8_t * pOutput);
+    void WriteChannelData16 (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
+    void WriteWideIntensityData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
+    void WriteAlignedWideIntensityData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
     bool validate ();        ///< confirm that the current configuration is valid
     inline uint32_t CalculateIntensityOffset(uint32_t ChannelId);
+
+    /// Pure pixel id translation for zig zag strings. Every other group of
+    /// ZigSize pixels runs backwards. Has no hardware or buffer dependencies.
+    static inline uint32_t ZigZagPixelId (uint32_t PixelId, uint32_t ZigSize)
+    {
+        uint32_t ZigZagGroupId = (1 < ZigSize) ? (PixelId / ZigSize) : 0;
+        if (0 != (ZigZagGroupId & 0x1))
+        {
+            PixelId = (ZigZagGroupId * ZigSize) + (ZigSize - 1) - (PixelId % ZigSize);
+        }
+        return PixelId;
+    }
+
+    inline uint8_t  DitherIntensity(uint8_t * pBuffer, uint32_t Intensity);
+    void updateIntensitySum ();     ///< Recalculate the intensity sum from the buffer content
+    inline uint32_t IRAM_ATTR ScaleIntensity (uint32_t Intensity)
+    {
+        return ((((Intensity ^ PowerInvertMask) * PowerScale) >> 8) ^ PowerInvertMask);
+    }
     uint32_t IRAM_ATTR GetIntensityData();
 
 public:
@@ -158,18 +264,23 @@ public:
     virtual  bool         SetConfig (ArduinoJson::JsonObject & jsonConfig); ///< Set a new config in the driver
     virtual  void         GetConfig (ArduinoJson::JsonObject & jsonConfig); ///< Get the current config used by the driver
     virtual  void         GetStatus (ArduinoJson::JsonObject& jsonStatus);
-             uint32_t     GetNumOutputBufferBytesNeeded () { return (pixel_count * NumIntensityBytesPerPixel); };
-             uint32_t     GetNumOutputBufferChannelsServiced () { return (GetNumOutputBufferBytesNeeded() / PixelGroupSize); };
+             uint32_t     GetNumOutputBufferBytesNeeded () { return (pixel_count * NumIntensityBytesPerPixel * BytesPerIntensity); };
+             uint32_t     GetNumOutputBufferChannelsServiced () { return (nullptr != pSegmentMap) ? (SegmentMapSize * InputBytesPerIntensity) : ((pixel_count * NumInputChannelsPerPixel * InputBytesPerIntensity) / PixelGroupSize); };
     virtual  void         SetOutputBufferSize (uint32_t NumChannelsAvailable);
-             void         SetInvertData (bool _InvertData) { InvertData = _InvertData; }
+             void         SetInvertData (bool _InvertData) { InvertData = _InvertData; updateGammaTable (); }
     virtual  void         WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
     virtual  void         ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData);
+    virtual  void         ClearBuffer ();
+    virtual  bool         IsIdentityMapped ();
+    virtual  bool         CanInterpolate () { return (1 == BytesPerIntensity) && (0 == PowerLimitMa); } ///< the power limit is worked out per input frame, not per blend
+    virtual  void         FrameCommitted (uint32_t PublishedBank) { BankIntensitySum[PublishedBank] = IntensitySum; }
     inline   void         SetIntensityBitTimeInUS (float value) { IntensityBitTimeInUs = value; }
              void         SetIntensityDataWidth(uint32_t value);
              void         StartNewFrame();
     inline   bool IRAM_ATTR ISR_MoreDataToSend () {return (&c_OutputPixel::FrameDone != FrameStateFuncPtr);}
              bool IRAM_ATTR ISR_GetNextIntensityToSend (uint32_t &DataToSend);
-    void                  SetPixelCount(uint32_t value) {pixel_count = value;}
+             uint32_t IRAM_ATTR ISR_GetNextIntensitiesToSend (uint32_t * pDataToSend, uint32_t MaxCount); ///< returns the number of intensities written
+    void                  SetPixelCount(uint32_t value) {pixel_count = value; updatePixelRemapTable();}
     uint32_t              GetPixelCount() {return pixel_count;}
 
 }; // c_OutputPixel
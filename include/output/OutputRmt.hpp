@@ -92,30 +92,59 @@ private:
     OutputRmtConfig_t   OutputRmtConfig;
 
     rmt_item32_t        Intensity2Rmt[RmtDataBitIdType_t::RMT_LIST_END];
+    rmt_item32_t        NibbleXlatTable[16][4];
+    bool                UseNibbleXlatTable = false;
     bool                OutputIsPaused   = false;
 
     uint32_t            NumRmtSlotsPerIntensityValue      = 8;
     uint32_t            NumRmtSlotOverruns                = 0;
     uint32_t            MaxNumRmtSlotsPerInterrupt        = (NUM_RMT_SLOTS/2);
 
-    rmt_item32_t    SendBuffer[NUM_RMT_SLOTS * 2];
+    // Staging area between the data source and the RMT driver. The driver pulls
+    // items from here into one half of the channel memory on each threshold
+    // interrupt while the other half is being sent. Size is fixed, so RAM use
+    // does not depend on the pixel count.
+#define RMT_SEND_BUFFER_SIZE    (NUM_RMT_SLOTS * 2)
+    rmt_item32_t    SendBuffer[RMT_SEND_BUFFER_SIZE];
     uint32_t        RmtBufferWriteIndex         = 0;
     uint32_t        SendBufferWriteIndex        = 0;
     uint32_t        SendBufferReadIndex         = 0;
     uint32_t        NumUsedEntriesInSendBuffer  = 0;
 
+    enum EncoderState_t
+    {
+        EncodeFrameStart = 0,
+        EncodeIntensityData,
+        EncodeFrameEnd,
+        EncodeDone,
+    };
+    EncoderState_t  EncoderState                = EncoderState_t::EncodeDone;
+    uint32_t        EncoderBitCount             = 0;
+    bool            EncoderSentData             = false;
+    uint8_t         EncoderSample               = 0;
+
+    // frames are sent on all channels at once. Completion is reported by the driver's tx end callback.
+    volatile bool   FrameInProgress             = false;
+    uint32_t        FrameKickoffMicroSec        = 0;
+    uint32_t        FrameLatencyMicroSec        = 0;
+    uint32_t        MaxFrameLatencyMicroSec     = 0;
+
 #define MIN_FRAME_TIME_MS 25
 
     uint32_t            TxIntensityDataStartingMask = 0x80;
     RmtDataBitIdType_t  InterIntensityValueId       = RMT_INVALID_VALUE;
 
-    inline void IRAM_ATTR ISR_TransferIntensityDataToRMT (uint32_t NumEntriesToTransfer);
+    static void IRAM_ATTR ISR_Translator (const void * pSource, rmt_item32_t * pDest, size_t SourceSize, size_t WantedNum, size_t * pTranslatedSize, size_t * pItemNum);
+    inline uint32_t IRAM_ATTR ISR_TransferIntensityDataToRMT (rmt_item32_t * pDest, uint32_t MaxNumEntriesToTransfer);
     inline void IRAM_ATTR ISR_CreateIntensityData ();
+    inline void IRAM_ATTR ISR_EncodeIntensitiesByNibble (const uint32_t * pIntensityValues, uint32_t NumIntensities);
     inline void IRAM_ATTR ISR_WriteToBuffer(uint32_t value);
     inline bool IRAM_ATTR ISR_MoreDataToSend();
     inline bool IRAM_ATTR ISR_GetNextIntensityToSend(uint32_t &DataToSend);
+    inline uint32_t IRAM_ATTR ISR_GetNextIntensitiesToSend(uint32_t * pDataToSend, uint32_t MaxCount);
     inline void IRAM_ATTR ISR_StartNewDataFrame();
     inline void IRAM_ATTR ISR_ResetRmtBlockPointers();
+    void InstallDriver                          ();
 
 #ifndef HasBeenInitialized
     bool HasBeenInitialized = false;
@@ -129,7 +158,10 @@ public:
 
     void Begin                                  (OutputRmtConfig_t config, c_OutputCommon * pParent);
     bool StartNewFrame                          ();
-    bool StartNextFrame                         () { return ((nullptr != pParent) & (!OutputIsPaused)) ? pParent->RmtPoll() : false; }
+    bool StartNextFrame                         () { return ((nullptr != pParent) && (!OutputIsPaused) && TxIsIdle()) ? pParent->RmtPoll() : false; }
+    void IRAM_ATTR ISR_FrameSent                ();
+    void CheckFrameTimeout                      ();
+    bool TxIsIdle                               ();
     void GetStatus                              (ArduinoJson::JsonObject& jsonStatus);
     void PauseOutput                            (bool State);
     inline uint32_t IRAM_ATTR GetRmtIntMask     ()               { return ((RMT_INT_TX_END_BIT | RMT_INT_ERROR_BIT | RMT_INT_ERROR_BIT)); }
@@ -149,7 +181,8 @@ public:
 
     void UpdateBitXlatTable(const CitrdsArray_t * CitrdsArray);
     bool ValidateBitXlatTable(const CitrdsArray_t * CitrdsArray);
-    void SetIntensity2Rmt (rmt_item32_t NewValue, RmtDataBitIdType_t ID) { Intensity2Rmt[ID] = NewValue; }
+    void UpdateNibbleXlatTable();
+    void SetIntensity2Rmt (rmt_item32_t NewValue, RmtDataBitIdType_t ID);
 
     bool ThereIsDataToSend = false;
     bool NoFrameInProgress () { return (0 == (RMT.int_ena.val & (RMT_ISR_BITS))); }
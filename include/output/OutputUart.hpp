@@ -142,7 +142,7 @@ private:
     void                    CalculateEnableUartInterruptFlags();
     inline uint32_t IRAM_ATTR   getUartFifoLength();
     inline bool     IRAM_ATTR   MoreDataToSend();
-    inline bool     IRAM_ATTR   GetNextIntensityToSend(uint32_t &DataToSend);
+    inline uint32_t IRAM_ATTR   GetNextIntensitiesToSend(uint32_t * pDataToSend, uint32_t MaxCount);
     inline void     IRAM_ATTR   enqueueUartData(uint8_t value);
     inline void     IRAM_ATTR   EnableUartInterrupts();
     inline void     IRAM_ATTR   ClearUartInterrupts();
@@ -0,0 +1,53 @@
+#pragma once
+/*
+ * GPIO_Defs_ESP32_DevkitC_I2S.hpp - Output Management class
+ *
+ * Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+ * Copyright (c) 2025 Shelby Merrick
+ * http://www.forkineye.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   DevkitC with 16 WS2811 strings on the I2S parallel output. GPIO 12 is
+ *   left out because it selects the flash voltage at boot.
+ *
+ */
+
+//Output Manager
+#define DEFAULT_RMT_0_GPIO      gpio_num_t::GPIO_NUM_32
+#define DEFAULT_RMT_1_GPIO      gpio_num_t::GPIO_NUM_33
+
+#define DEFAULT_I2S_0_GPIO      gpio_num_t::GPIO_NUM_2
+#define DEFAULT_I2S_1_GPIO      gpio_num_t::GPIO_NUM_4
+#define DEFAULT_I2S_2_GPIO      gpio_num_t::GPIO_NUM_5
+#define DEFAULT_I2S_3_GPIO      gpio_num_t::GPIO_NUM_13
+#define DEFAULT_I2S_4_GPIO      gpio_num_t::GPIO_NUM_14
+#define DEFAULT_I2S_5_GPIO      gpio_num_t::GPIO_NUM_15
+#define DEFAULT_I2S_6_GPIO      gpio_num_t::GPIO_NUM_16
+#define DEFAULT_I2S_7_GPIO      gpio_num_t::GPIO_NUM_17
+#define DEFAULT_I2S_8_GPIO      gpio_num_t::GPIO_NUM_18
+#define DEFAULT_I2S_9_GPIO      gpio_num_t::GPIO_NUM_19
+#define DEFAULT_I2S_10_GPIO     gpio_num_t::GPIO_NUM_21
+#define DEFAULT_I2S_11_GPIO     gpio_num_t::GPIO_NUM_22
+#define DEFAULT_I2S_12_GPIO     gpio_num_t::GPIO_NUM_23
+#define DEFAULT_I2S_13_GPIO     gpio_num_t::GPIO_NUM_25
+#define DEFAULT_I2S_14_GPIO     gpio_num_t::GPIO_NUM_26
+#define DEFAULT_I2S_15_GPIO     gpio_num_t::GPIO_NUM_27
+
+// Output Types
+#define SUPPORT_OutputType_DMX              // UART / RMT
+#define SUPPORT_OutputType_GS8208           // UART / RMT
+#define SUPPORT_OutputType_Renard           // UART / RMT
+#define SUPPORT_OutputType_Serial           // UART / RMT
+#define SUPPORT_OutputType_TM1814           // UART / RMT
+#define SUPPORT_OutputType_UCS1903          // UART / RMT
+#define SUPPORT_OutputType_UCS8903          // UART / RMT
+#define SUPPORT_OutputType_WS2811           // UART / RMT / I2S
@@ -43,12 +43,15 @@ const CN_PROGMEM char CN_blanktime                [] = "blanktime";
 const CN_PROGMEM char CN_bridge                   [] = "bridge";
 const CN_PROGMEM char CN_brightness               [] = "brightness";
 const CN_PROGMEM char CN_brightnessEnd            [] = "brightnessEnd";
+const CN_PROGMEM char CN_capture                  [] = "capture";
 const CN_PROGMEM char CN_cfgver                   [] = "cfgver";
+const CN_PROGMEM char CN_channel_current          [] = "channel_current";
 const CN_PROGMEM char CN_channels                 [] = "channels";
 const CN_PROGMEM char CN_clean                    [] = "clean";
 const CN_PROGMEM char CN_clock_pin                [] = "clock_pin";
 const CN_PROGMEM char CN_cmd                      [] = "cmd";
 const CN_PROGMEM char CN_color                    [] = "color";
+const CN_PROGMEM char CN_color_matrix             [] = "color_matrix";
 const CN_PROGMEM char CN_color_order              [] = "color_order";
 const CN_PROGMEM char CN_Configuration_File_colon [] = "Configuration File: ";
 const CN_PROGMEM char CN_config                   [] = "config";
@@ -63,9 +66,11 @@ const CN_PROGMEM char CN_Default                  [] = "Default";
 const CN_PROGMEM char CN_device                   [] = "device";
 const CN_PROGMEM char CN_dhcp                     [] = "dhcp";
 const CN_PROGMEM char CN_Disabled                 [] = "Disabled";
+const CN_PROGMEM char CN_dither                   [] = "dither";
 const CN_PROGMEM char CN_dnsp                     [] = "dnsp";
 const CN_PROGMEM char CN_dnss                     [] = "dnss";
 const CN_PROGMEM char CN_DMX                      [] = "DMX";
+const CN_PROGMEM char CN_DoubleBuffer             [] = "DoubleBuffer";
 const CN_PROGMEM char CN_Dotfseq                  [] = ".fseq";
 const CN_PROGMEM char CN_Dotjson                  [] = ".json";
 const CN_PROGMEM char CN_Dotpl                    [] = ".pl";
@@ -97,6 +102,7 @@ const CN_PROGMEM char CN_file                     [] = "file";
 const CN_PROGMEM char CN_filename                 [] = "filename";
 const CN_PROGMEM char CN_files                    [] = "files";
 const CN_PROGMEM char CN_FPPoverride              [] = "FPPoverride";
+const CN_PROGMEM char CN_FrameRate                [] = "FrameRate";
 const CN_PROGMEM char CN_Frequency                [] = "Frequency";
 const CN_PROGMEM char CN_fseqfilelist             [] = "/fseqfilelist";
 const CN_PROGMEM char CN_fseqfilename             [] = "fseqfilename";
@@ -119,11 +125,14 @@ const CN_PROGMEM char CN_hv                       [] = "hv";
 const CN_PROGMEM char CN_id                       [] = "id";
 const CN_PROGMEM char CN_Idle                     [] = "Idle";
 const CN_PROGMEM char CN_init                     [] = "init";
+const CN_PROGMEM char CN_input_16bit              [] = "input_16bit";
 const CN_PROGMEM char CN_interframetime           [] = "interframetime";
+const CN_PROGMEM char CN_Interpolate              [] = "Interpolate";
 const CN_PROGMEM char CN_inv                      [] = "inv";
 const CN_PROGMEM char CN_ip                       [] = "ip";
 const CN_PROGMEM char CN_input                    [] = "input";
 const CN_PROGMEM char CN_input_config             [] = "input_config";
+const CN_PROGMEM char CN_KeepAliveMs              [] = "KeepAliveMs";
 const CN_PROGMEM char CN_last_clientIP            [] = "last_clientIP";
 const CN_PROGMEM char CN_long                     [] = "long";
 const CN_PROGMEM char CN_lwt                      [] = "lwt";
@@ -168,6 +177,7 @@ const CN_PROGMEM char CN_plussigns                [] = "+++++";
 const CN_PROGMEM char CN_polarity                 [] = "polarity";
 const CN_PROGMEM char CN_PollCounter              [] = "PollCounter";
 const CN_PROGMEM char CN_port                     [] = "port";
+const CN_PROGMEM char CN_power_limit              [] = "power_limit";
 const CN_PROGMEM char CN_power_pin                [] = "power_pin";
 const CN_PROGMEM char CN_prependnullcount         [] = "prependnullcount";
 const CN_PROGMEM char CN_pwm                      [] = "pwm";
@@ -185,6 +195,7 @@ const CN_PROGMEM char CN_sdspeed                  [] = "sdspeed";
 const CN_PROGMEM char CN_seconds_elapsed          [] = "seconds_elapsed";
 const CN_PROGMEM char CN_seconds_played           [] = "seconds_played";
 const CN_PROGMEM char CN_seconds_remaining        [] = "seconds_remaining";
+const CN_PROGMEM char CN_segments                 [] = "segments";
 const CN_PROGMEM char CN_SendFppSync              [] = "SendFppSync";
 const CN_PROGMEM char CN_sensor                   [] = "sensor";
 const CN_PROGMEM char CN_sequence_filename        [] = "sequence_filename";
@@ -196,6 +207,7 @@ const CN_PROGMEM char CN_speed                    [] = "speed";
 const CN_PROGMEM char CN_ssid                     [] = "ssid";
 const CN_PROGMEM char CN_sta_timeout              [] = "sta_timeout";
 const CN_PROGMEM char CN_stars                    [] = "***";
+const CN_PROGMEM char CN_start_channel            [] = "start_channel";
 const CN_PROGMEM char CN_state                    [] = "state";
 const CN_PROGMEM char CN_status                   [] = "status";
 const CN_PROGMEM char CN_status_name              [] = "status_name";
@@ -232,6 +244,8 @@ const CN_PROGMEM char CN_user                     [] = "user";
 const CN_PROGMEM char CN_version                  [] = "version";
 const CN_PROGMEM char CN_Version                  [] = "Version";
 const CN_PROGMEM char CN_weus                     [] = "weus";
+const CN_PROGMEM char CN_white_extract            [] = "white_extract";
+const CN_PROGMEM char CN_white_point              [] = "white_point";
 const CN_PROGMEM char CN_wifi                     [] = "wifi";
 const CN_PROGMEM char CN_WiFiDrv                  [] = "WiFiDrv";
 const CN_PROGMEM char CN_WS2801                   [] = "WS2801";
@@ -267,6 +267,51 @@ void c_WebMgr::init ()
             }
         });
 
+        // /capture/record/<NumFrames>/<FileName>, /capture/replay/<FileName>, /capture/stop
+    	webServer.on ("/capture", HTTP_GET | HTTP_OPTIONS, [](AsyncWebServerRequest* request)
+        {
+            // DEBUG_V("capture")
+            if(HTTP_OPTIONS == request->method())
+            {
+                request->send (200);
+            }
+            else
+            {
+                // DEBUG_V(String("url: ") + request->url ());
+                String Action = request->url ().substring (String (F("/capture/")).length ());
+                String Parameters = emptyString;
+                int EndActionPos = Action.indexOf('/');
+                if(-1 != EndActionPos)
+                {
+                    Parameters = Action.substring(EndActionPos+1);
+                    Action = Action.substring(0, EndActionPos);
+                }
+                // DEBUG_V(String("Action: '") + Action + "'");
+                // DEBUG_V(String("Parameters: '") + Parameters + "'");
+
+                int EndCountPos = Parameters.indexOf('/');
+                if(Action.equalsIgnoreCase(F("stop")))
+                {
+                    OutputMgr.StopCapture();
+                    request->send (200, CN_textSLASHplain, F("OK"));
+                }
+                else if(Action.equalsIgnoreCase(F("replay")) && !Parameters.isEmpty())
+                {
+                    OutputMgr.StartReplay(Parameters);
+                    request->send (200, CN_textSLASHplain, F("OK"));
+                }
+                else if(Action.equalsIgnoreCase(F("record")) && (0 < EndCountPos) && (int(Parameters.length()) > (EndCountPos+1)) && (0 < Parameters.toInt()))
+                {
+                    OutputMgr.StartCapture(Parameters.substring(EndCountPos+1), Parameters.toInt());
+                    request->send (200, CN_textSLASHplain, F("OK"));
+                }
+                else
+                {
+                    request->send (400, CN_textSLASHplain, F("Invalid capture request"));
+                }
+            }
+        });
+
     	webServer.on ("/clearstatistics", HTTP_POST | HTTP_OPTIONS, [](AsyncWebServerRequest* request)
         {
             // DEBUG_V("clearstatistics - start")
@@ -319,7 +364,7 @@ void c_WebMgr::init ()
                             // DEBUG_V(String("NumBytesAvailableToSend: ") + String(NumBytesAvailableToSend));
                             if(0 != NumBytesAvailableToSend)
                             {
-                                memcpy(buffer, OutputMgr.GetBufferAddress () + index, NumBytesAvailableToSend);
+                                OutputMgr.ReadOutputBuffer (index, NumBytesAvailableToSend, buffer);
                             }
                             return NumBytesAvailableToSend;
                         });
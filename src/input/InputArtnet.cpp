@@ -172,6 +172,12 @@ void c_InputArtnet::onDmxFrame (uint16_t  CurrentUniverseId,
                                  min(CurrentUniverse.BytesToCopy, length),
                                  &data[CurrentUniverse.SourceDataOffset]);
 
+        // the last universe completes the frame
+        if (LastUniverse == CurrentUniverseId)
+        {
+            OutputMgr.CommitFrame ();
+        }
+
         InputMgr.RestartBlankTimer (GetInputChannelId ());
     }
     else
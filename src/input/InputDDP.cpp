@@ -166,16 +166,24 @@ void c_InputDDP::NetworkStateChanged (bool IsConnected)
 } // NetworkStateChanged
 
 //-----------------------------------------------------------------------------
-void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket ReceivedPacket)
+void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket & ReceivedPacket)
 {
     // DEBUG_START;
 
     do // once
     {
         DDP_packet_t & packet = *((DDP_packet_t * )(ReceivedPacket.data ()));
+        uint32_t PacketLength = ReceivedPacket.length ();
 
         stats.packetsReceived++;
-        stats.bytesReceived += ReceivedPacket.length ();
+        stats.bytesReceived += PacketLength;
+
+        if (PacketLength < DDP_Header_t_LEN)
+        {
+            stats.errors++;
+            lastError = String(F("Packet too short: ")) + String(PacketLength);
+            break;
+        }
 
         if ((packet.header.flags1 & DDP_FLAGS1_VERMASK) != DDP_FLAGS1_VER1)
         {
@@ -185,10 +193,17 @@ void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket ReceivedPacket)
             break;
         }
 
-        // need to fast track data
+        // Data goes straight from the received packet to the outputs
         if (true == IsData(packet.header.flags1))
         {
-            ProcessReceivedData (packet);
+            uint32_t DataOffset = DDP_Header_t_LEN + ((IsTime(packet.header.flags1)) ? sizeof (DDP_TimeCode_packet_t::TimeCode) : 0);
+            if (PacketLength < DataOffset)
+            {
+                stats.errors++;
+                lastError = String(F("Packet too short: ")) + String(PacketLength);
+                break;
+            }
+            ProcessReceivedData (packet.header, &ReceivedPacket.data ()[DataOffset], PacketLength - DataOffset);
             break;
         }
 
@@ -202,7 +217,7 @@ void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket ReceivedPacket)
 
         PacketBuffer.ResponseAddress = ReceivedPacket.remoteIP ();
         PacketBuffer.ResponsePort = ReceivedPacket.remotePort ();
-        memcpy ((void*)&PacketBuffer.Packet, ReceivedPacket.data (), sizeof (PacketBuffer.Packet));
+        memcpy ((void*)&PacketBuffer.Packet, ReceivedPacket.data (), min (PacketLength, uint32_t (sizeof (PacketBuffer.Packet))));
         PacketBuffer.PacketBufferStatus = PacketBufferStatus_t::BufferIsFilled;
 
     } while (false);
@@ -232,13 +247,6 @@ void c_InputDDP::Process ()
         // DEBUG_V ("There is something in the buffer for us to process");
         PacketBuffer.PacketBufferStatus = PacketBufferStatus_t::BufferIsBeingProcessed;
 
-        if (true == IsData(PacketBuffer.Packet.header.flags1))
-        {
-            ProcessReceivedData (PacketBuffer.Packet);
-            PacketBuffer.PacketBufferStatus = PacketBufferStatus_t::BufferIsAvailable;
-            break;
-        }
-
         if (true == IsQuery (PacketBuffer.Packet.header.flags1))
         {
             ProcessReceivedQuery ();
@@ -257,20 +265,28 @@ void c_InputDDP::Process ()
 } // Process
 
 //-----------------------------------------------------------------------------
-void c_InputDDP::ProcessReceivedData (DDP_packet_t & Packet)
+/*
+*   Data points into the received packet. DataLength is how much of the
+*   packet follows the header, which bounds what the header may claim.
+*/
+void c_InputDDP::ProcessReceivedData (DDP_Header_t & header, byte * Data, uint32_t DataLength)
 {
     // DEBUG_START;
 
     do // once
     {
-        DDP_Header_t & header = Packet.header;
-        // DEBUG_V (String ("              header: 0x") + String (uint32_t (&Packet.header), HEX));
-
         // is the offset and length valid?
 
         uint32_t InputBufferOffset = ntohl (header.channelOffset);
         uint32_t packetDataLength  = ntohs (header.dataLen);
 
+        if (packetDataLength > DataLength)
+        {
+            lastError = String(F("Truncated packet. Expected ")) + String(packetDataLength) + F(" bytes of data. Got ") + String(DataLength);
+            stats.errors++;
+            packetDataLength = DataLength;
+        }
+
         // DEBUG_V (String ("    packetDataLength: ") + String (packetDataLength));
         // DEBUG_V (String (" InputDataBufferSize: ") + String (InputDataBufferSize));
 
@@ -294,10 +310,18 @@ void c_InputDDP::ProcessReceivedData (DDP_packet_t & Packet)
         }
         // DEBUG_V (String (" AdjPacketDataLength: ") + String (AdjPacketDataLength));
 
-        byte* Data = (IsTime(header.flags1)) ? &((DDP_TimeCode_packet_t&)Packet).data[0] : &Packet.data[0];
         // DEBUG_V (String ("                Data: 0x") + String (uint32_t (Data), HEX));
         // DEBUG_V (String ("   InputBufferOffset: ") + String (InputBufferOffset));
-        OutputMgr.WriteChannelData(InputBufferOffset, AdjPacketDataLength, &Data[0]);
+        if (AdjPacketDataLength)
+        {
+            OutputMgr.WriteChannelData(InputBufferOffset, AdjPacketDataLength, Data);
+        }
+
+        // the sender uses the push flag to mark the end of a frame
+        if (IsPush(header.flags1))
+        {
+            OutputMgr.CommitFrame ();
+        }
 
         InputMgr.RestartBlankTimer (GetInputChannelId ());
 
@@ -19,6 +19,21 @@
 
 #include "input/InputE131.hpp"
 #include "network/NetworkMgr.hpp"
+#include <lwip/igmp.h>
+
+static const uint8_t ACN_ID[] = { 0x41, 0x53, 0x43, 0x2d, 0x45, 0x31, 0x2e, 0x31, 0x37, 0x00, 0x00, 0x00 };
+
+//-----------------------------------------------------------------------------
+// E1.31 fields are big endian and not aligned
+static inline uint32_t ReadPacketField (e131_packet_t * packet, uint32_t Offset, uint32_t NumBytes)
+{
+    uint32_t response = 0;
+    for (uint32_t index = 0; index < NumBytes; ++index)
+    {
+        response = (response << 8) | packet->raw[Offset + index];
+    }
+    return response;
+} // ReadPacketField
 
 //-----------------------------------------------------------------------------
 c_InputE131::c_InputE131 (c_InputMgr::e_InputChannelIds NewInputChannelId,
@@ -29,7 +44,7 @@ c_InputE131::c_InputE131 (c_InputMgr::e_InputChannelIds NewInputChannelId,
     // DEBUG_START;
 
     // DEBUG_V ("BufferSize: " + String (BufferSize));
-    memset (_e131, 0x00, sizeof (_e131));
+    memset (_udp, 0x00, sizeof (_udp));
     memset ((void*)UniverseArray, 0x00, sizeof (UniverseArray));
 
     // DEBUG_END;
@@ -40,6 +55,12 @@ c_InputE131::~c_InputE131()
 {
     // DEBUG_START;
 
+    if (pUdp)
+    {
+        pUdp->~AsyncUDP ();
+        pUdp = nullptr;
+    }
+
     // DEBUG_END;
 
 } // ~c_InputE131
@@ -59,15 +80,11 @@ void c_InputE131::Begin ()
         }
 
         // DEBUG_V ("InputDataBufferSize: " + String(InputDataBufferSize));
-        if(nullptr == pE131)
+        if(nullptr == pUdp)
         {
-            pE131 = new(&_e131[0]) ESPAsyncE131(0);
+            pUdp = new(&_udp[0]) AsyncUDP();
             // DEBUG_V ("");
-            pE131->registerCallback ( (void*)this, [] (e131_packet_t* Packet, void * pThis)
-                {
-                    // DEBUG_V ("");
-                    ((c_InputE131*)pThis)->ProcessIncomingE131Data (Packet);
-                });
+            pUdp->onPacket (std::bind (&c_InputE131::ProcessReceivedUdpPacket, this, std::placeholders::_1));
             // DEBUG_V ("");
         }
 
@@ -110,12 +127,16 @@ void c_InputE131::GetStatus (JsonObject & jsonStatus)
     JsonWrite(e131Status, CN_unilast,    LastUniverse);
     JsonWrite(e131Status, CN_unichanlim, ChannelsPerUniverse);
 
-    JsonWrite(e131Status, CN_num_packets,   pE131->stats.num_packets);
-    JsonWrite(e131Status, CN_last_clientIP, uint32_t(pE131->stats.last_clientIP));
+    JsonWrite(e131Status, CN_num_packets,   PacketCounter);
+    JsonWrite(e131Status, F("sync_universe"), SyncUniverse);
+    JsonWrite(e131Status, F("sync_packets"),  SyncPacketCounter);
+    // universes are only held back for the sync packet when the outputs are double buffered
+    JsonWrite(e131Status, F("sync_staged"),   (0 != SyncUniverse) && OutputMgr.FramesAreStaged ());
+    JsonWrite(e131Status, CN_last_clientIP, LastClientIP);
     // DEBUG_V ("");
 
     JsonArray e131UniverseStatus = e131Status[(char*)CN_channels].to<JsonArray> ();
-    uint32_t TotalErrors = 0; // pE131->stats.packet_errors;
+    uint32_t TotalErrors = PacketErrorCounter;
     for (auto & CurrentUniverse : UniverseArray)
     {
         JsonObject e131CurrentUniverseStatus = e131UniverseStatus.add<JsonObject> ();
@@ -136,7 +157,9 @@ void c_InputE131::ClearStatistics ()
     // DEBUG_START;
 
 
-    pE131->stats.num_packets = 0;
+    PacketCounter = 0;
+    PacketErrorCounter = 0;
+    SyncPacketCounter = 0;
     // DEBUG_V ("");
 
     for (auto & CurrentUniverse : UniverseArray)
@@ -158,6 +181,71 @@ void c_InputE131::Process ()
 
 } // process
 
+//-----------------------------------------------------------------------------
+/*
+*   Check the framing of everything that arrives on the E1.31 port. Data
+*   packets and sync packets are passed on. Anything else is counted as an
+*   error and dropped.
+*/
+void c_InputE131::ProcessReceivedUdpPacket (AsyncUDPPacket & ReceivedPacket)
+{
+    // DEBUG_START;
+
+    e131_packet_t * packet = (e131_packet_t *)ReceivedPacket.data ();
+    uint32_t PacketLength = ReceivedPacket.length ();
+
+    do // once
+    {
+        if ((PacketLength < SYNC_PACKET_LENGTH) ||
+            (0 != memcmp (&packet->raw[ACN_ID_OFFSET], ACN_ID, ACN_ID_LENGTH)))
+        {
+            ++PacketErrorCounter;
+            break;
+        }
+
+        ++PacketCounter;
+        LastClientIP = uint32_t (ReceivedPacket.remoteIP ());
+
+        uint32_t RootVector  = ReadPacketField (packet, ROOT_VECTOR_OFFSET, 4);
+        uint32_t FrameVector = ReadPacketField (packet, FRAME_VECTOR_OFFSET, 4);
+
+        if ((VECTOR_ROOT_E131_EXTENDED == RootVector) && (VECTOR_E131_EXTENDED_SYNC == FrameVector))
+        {
+            ProcessIncomingSyncPacket (packet);
+            break;
+        }
+
+        if ((VECTOR_ROOT_E131_DATA != RootVector) ||
+            (VECTOR_E131_DATA_PACKET != FrameVector) ||
+            (PacketLength < DATA_PACKET_MIN_LENGTH) ||
+            (VECTOR_DMP_SET_PROPERTY != packet->raw[DMP_VECTOR_OFFSET]))
+        {
+            ++PacketErrorCounter;
+            break;
+        }
+
+        // the property values start with the start code. Only DMX data (start code zero) goes to the outputs
+        uint32_t PropertyValueCount = ntohs (packet->property_value_count);
+        if ((0 == PropertyValueCount) ||
+            ((PROPERTY_VALUES_OFFSET + PropertyValueCount) > PacketLength))
+        {
+            ++PacketErrorCounter;
+            break;
+        }
+
+        if (0 != packet->property_values[0])
+        {
+            break;
+        }
+
+        ProcessIncomingE131Data (packet);
+
+    } while (false);
+
+    // DEBUG_END;
+
+} // ProcessReceivedUdpPacket
+
 //-----------------------------------------------------------------------------
 void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
 {
@@ -204,6 +292,19 @@ void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
             OutputMgr.WriteChannelData(CurrentUniverse.DestinationOffset,
                                     min(CurrentUniverse.BytesToCopy, NumBytesOfE131Data),
                                     &E131Data[CurrentUniverse.SourceDataOffset]);
+
+            // A synchronized sender completes the frame with a sync packet.
+            // If the sync packets stop arriving, the last universe completes the frame.
+            uint16_t PacketSyncUniverse = uint16_t (ReadPacketField (packet, DATA_SYNC_ADDRESS_OFFSET, 2));
+            if (PacketSyncUniverse != SyncUniverse)
+            {
+                SetSyncUniverse (PacketSyncUniverse);
+            }
+            bool WaitForSync = (0 != SyncUniverse) && ((millis () - LastSyncPacketMS) < SYNC_TIMEOUT_MS);
+            if (!WaitForSync && (LastUniverse == CurrentUniverseId))
+            {
+                OutputMgr.CommitFrame ();
+            }
 /*
             memcpy(CurrentUniverse.Destination,
                    &E131Data[CurrentUniverse.SourceDataOffset],
@@ -222,6 +323,89 @@ void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
 
 } // process
 
+//-----------------------------------------------------------------------------
+void c_InputE131::ProcessIncomingSyncPacket (e131_packet_t * packet)
+{
+    // DEBUG_START;
+
+    uint16_t SyncAddress = uint16_t (ReadPacketField (packet, SYNC_SYNC_ADDRESS_OFFSET, 2));
+    // DEBUG_V (String ("SyncAddress: ") + String (SyncAddress));
+
+    // only the sync universe our data is waiting on is of interest
+    if ((0 != SyncUniverse) && (SyncAddress == SyncUniverse))
+    {
+        ++SyncPacketCounter;
+        LastSyncPacketMS = millis ();
+
+        // all of the staged universes go out together
+        OutputMgr.CommitFrame ();
+    }
+
+    // DEBUG_END;
+
+} // ProcessIncomingSyncPacket
+
+//-----------------------------------------------------------------------------
+/*
+*   The sender has started (or stopped) using a sync universe. Multicast sync
+*   packets are sent to the sync universe group, which has to be joined to
+*   hear them.
+*/
+void c_InputE131::SetSyncUniverse (uint16_t NewSyncUniverse)
+{
+    // DEBUG_START;
+
+    // the data universe groups are joined for as long as we are listening
+    if ((0 != SyncUniverse) && ((SyncUniverse < startUniverse) || (SyncUniverse > LastUniverse)))
+    {
+        JoinUniverseGroup (SyncUniverse, false);
+    }
+
+    SyncUniverse = NewSyncUniverse;
+
+    if ((0 != SyncUniverse) && ((SyncUniverse < startUniverse) || (SyncUniverse > LastUniverse)))
+    {
+        JoinUniverseGroup (SyncUniverse, true);
+    }
+
+    if (0 == SyncUniverse)
+    {
+        logcon (F ("Universe synchronization stopped"));
+    }
+    else if (OutputMgr.FramesAreStaged ())
+    {
+        logcon (String (F ("Universe synchronization on universe ")) + SyncUniverse);
+    }
+    else
+    {
+        logcon (String (F ("Universe synchronization on universe ")) + SyncUniverse +
+                F (" needs the output DoubleBuffer option. Universes are sent as they arrive."));
+    }
+
+    // DEBUG_END;
+
+} // SetSyncUniverse
+
+//-----------------------------------------------------------------------------
+void c_InputE131::JoinUniverseGroup (uint16_t Universe, bool Join)
+{
+    // DEBUG_START;
+
+    ip4_addr_t GroupAddress;
+    IP4_ADDR (&GroupAddress, 239, 255, uint8_t (Universe >> 8), uint8_t (Universe));
+
+    err_t Error = (Join) ? igmp_joingroup (IP4_ADDR_ANY4, &GroupAddress) :
+                           igmp_leavegroup (IP4_ADDR_ANY4, &GroupAddress);
+    if (ERR_OK != Error)
+    {
+        logcon (String (F ("Could not ")) + ((Join) ? F ("join") : F ("leave")) +
+                F (" the multicast group for universe ") + Universe);
+    }
+
+    // DEBUG_END;
+
+} // JoinUniverseGroup
+
 //-----------------------------------------------------------------------------
 void c_InputE131::SetBufferInfo (uint32_t BufferSize)
 {
@@ -301,7 +485,7 @@ bool c_InputE131::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     setFromJSON (FirstUniverseChannelOffset, jsonConfig, CN_universe_start);
     setFromJSON (PortId,                     jsonConfig, CN_port);
 
-    if ((OldPortId != PortId) && (ESPAsyncE131Initialized))
+    if ((OldPortId != PortId) && (UdpInitialized))
     {
         // ask for a reboot.
         String Reason = (String (F ("Requesting reboot on change of UDP port.")));
@@ -389,8 +573,9 @@ void c_InputE131::NetworkStateChanged (bool IsConnected, bool ReBootAllowed)
 
     if (IsConnected)
     {
-        // Get on with business
-        if (pE131->begin (e131_listen_t::E131_MULTICAST, PortId, startUniverse, LastUniverse - startUniverse + 1))
+        // Get on with business. The port is bound to any address so unicast packets arrive as well
+        IPAddress FirstUniverseGroup (239, 255, uint8_t (startUniverse >> 8), uint8_t (startUniverse));
+        if (pUdp->listenMulticast (FirstUniverseGroup, PortId))
         {
             // logcon (String (F ("Multicast enabled")));
         }
@@ -401,13 +586,14 @@ void c_InputE131::NetworkStateChanged (bool IsConnected, bool ReBootAllowed)
 
         // DEBUG_V ("");
 
-        if (pE131->begin (e131_listen_t::E131_UNICAST, PortId, startUniverse, LastUniverse - startUniverse + 1))
+        for (uint32_t Universe = startUniverse + 1; Universe <= LastUniverse; ++Universe)
         {
-            // logcon (String (F ("Listening on port ")) + PortId);
+            JoinUniverseGroup (uint16_t (Universe), true);
         }
-        else
+
+        if ((0 != SyncUniverse) && ((SyncUniverse < startUniverse) || (SyncUniverse > LastUniverse)))
         {
-            logcon (CN_stars + String (F (" E1.31 UNICAST INIT FAILED ")) + CN_stars);
+            JoinUniverseGroup (SyncUniverse, true);
         }
 
         logcon (String (F ("Listening for ")) + InputDataBufferSize +
@@ -415,7 +601,7 @@ void c_InputE131::NetworkStateChanged (bool IsConnected, bool ReBootAllowed)
                         F (" to ") + LastUniverse +
                         F (" on port ") + PortId);
 
-        ESPAsyncE131Initialized = true;
+        UdpInitialized = true;
     }
     else if (ReBootAllowed)
     {
@@ -324,6 +324,7 @@ void c_InputEffectEngine::PollFlash ()
         color.g = intensity;
         color.b = intensity;
         setAll(color);
+        OutputMgr.CommitFrame ();
     } while(false);
 
 } // PollFlash
@@ -366,6 +367,7 @@ void c_InputEffectEngine::Process ()
         }
         EffectCounter++;
         InputMgr.RestartBlankTimer (GetInputChannelId ());
+        OutputMgr.CommitFrame ();
 
         PollFlash();
 
@@ -344,6 +344,9 @@ bool fsm_PlayFile_state_PlayingFile::Poll ()
             }
         }
 
+        // the whole frame is in the buffer
+        OutputMgr.CommitFrame ();
+
     } while (false);
 
     ///DEBUG_END;
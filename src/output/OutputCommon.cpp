@@ -37,6 +37,7 @@ c_OutputCommon::c_OutputCommon (c_OutputMgr::e_OutputChannelIds _OutputChannelId
 	UartId                   = uart;
     OutputType               = outputType;
     pOutputBuffer            = OutputMgr.GetBufferAddress ();
+    pBackBuffer              = pOutputBuffer;
     FrameStartTimeInMicroSec = 0;
 
 	// logcon (String ("UartId:          '") + UartId + "'");
@@ -51,9 +52,33 @@ c_OutputCommon::~c_OutputCommon ()
 {
     // DEBUG_START;
 
+    ReleaseFrontBuffer ();
+
     // DEBUG_END;
 } // ~c_OutputCommon
 
+//----------------------------------------------------------------------------
+// min / avg / max of one column of the timing history. The history is too
+// short for a meaningful percentile
+static void WriteTimingStats (JsonObject & jsonTiming, const __FlashStringHelper * Name, uint32_t * Values, uint32_t Count)
+{
+    uint64_t Sum = 0;
+    uint32_t Min = Values[0];
+    uint32_t Max = Values[0];
+    for (uint32_t i = 0; i < Count; ++i)
+    {
+        Sum += Values[i];
+        Min  = min (Min, Values[i]);
+        Max  = max (Max, Values[i]);
+    }
+
+    JsonObject jsonStats = jsonTiming[Name].to<JsonObject> ();
+    JsonWrite(jsonStats, F("min"), Min);
+    JsonWrite(jsonStats, F("avg"), uint32_t (Sum / Count));
+    JsonWrite(jsonStats, F("max"), Max);
+
+} // WriteTimingStats
+
 //-----------------------------------------------------------------------------
 void c_OutputCommon::BaseGetStatus (JsonObject & jsonStatus)
 {
@@ -63,6 +88,37 @@ void c_OutputCommon::BaseGetStatus (JsonObject & jsonStatus)
     JsonWrite(jsonStatus, F("framerefreshrate"), int(MicroSecondsInASecond / FrameDurationInMicroSec));
     JsonWrite(jsonStatus, F("FrameCount"),       FrameCount);
 
+    if (OutputMgr.GetFrameTickPeriodMicroSec ())
+    {
+        JsonWrite(jsonStatus, F("TickOffsetUs"),    TickOffsetMicroSec);
+        JsonWrite(jsonStatus, F("TickOffsetMaxUs"), TickOffsetMaxMicroSec);
+        JsonWrite(jsonStatus, F("TickJitterUs"),    TickJitterMicroSec);
+    }
+
+    uint32_t NumSamples = min (TimingHistoryCount, uint32_t (OUTPUT_TIMING_HISTORY_SIZE));
+    if (NumSamples)
+    {
+        uint32_t Build[OUTPUT_TIMING_HISTORY_SIZE];
+        uint32_t Transmit[OUTPUT_TIMING_HISTORY_SIZE];
+        uint32_t Gap[OUTPUT_TIMING_HISTORY_SIZE];
+        uint32_t Isr[OUTPUT_TIMING_HISTORY_SIZE];
+        for (uint32_t i = 0; i < NumSamples; ++i)
+        {
+            Build[i]    = TimingHistory[i].BuildUs;
+            Transmit[i] = TimingHistory[i].TransmitUs;
+            Gap[i]      = TimingHistory[i].GapUs;
+            Isr[i]      = TimingHistory[i].IsrUs;
+        }
+
+        JsonObject jsonTiming = jsonStatus[F("timing")].to<JsonObject> ();
+        JsonWrite(jsonTiming, F("samples"),         NumSamples);
+        JsonWrite(jsonTiming, F("MissedDeadlines"), MissedDeadlines);
+        WriteTimingStats (jsonTiming, F("BuildUs"),    Build,    NumSamples);
+        WriteTimingStats (jsonTiming, F("TransmitUs"), Transmit, NumSamples);
+        WriteTimingStats (jsonTiming, F("GapUs"),      Gap,      NumSamples);
+        WriteTimingStats (jsonTiming, F("IsrUs"),      Isr,      NumSamples);
+    }
+
     // DEBUG_END;
 } // GetStatus
 
@@ -74,12 +130,89 @@ void c_OutputCommon::ReportNewFrame ()
     uint32_t Now = micros ();
 
     FrameStartTimeInMicroSec    = Now;
+    FrameBuiltTimeInMicroSec    = Now;
+    FrameIsrMicroSec            = 0;
+    OutputBufferIsDirty         = false;
+    FrameKicked                 = false;
     FrameCount++;
 
+    uint32_t TickPeriodMicroSec = OutputMgr.GetFrameTickPeriodMicroSec ();
+    if (TickPeriodMicroSec)
+    {
+        LastFrameTick = Now / TickPeriodMicroSec;
+        uint32_t TickOffset = Now - (LastFrameTick * TickPeriodMicroSec);
+
+        // smoothed the same way as RTP interarrival jitter (RFC 3550)
+        int32_t Delta = abs (int32_t (TickOffset) - int32_t (TickOffsetMicroSec));
+        TickJitterMicroSec = uint32_t (int32_t (TickJitterMicroSec) + ((Delta - int32_t (TickJitterMicroSec)) / 16));
+
+        TickOffsetMicroSec    = TickOffset;
+        TickOffsetMaxMicroSec = max (TickOffsetMaxMicroSec, TickOffset);
+    }
+
     // DEBUG_END;
 
 } // ReportNewFrame
 
+//----------------------------------------------------------------------------
+static inline uint16_t IRAM_ATTR SaturateTo16 (uint32_t value)
+{
+    return uint16_t ((value > 0xffff) ? 0xffff : value);
+} // SaturateTo16
+
+//----------------------------------------------------------------------------
+void IRAM_ATTR c_OutputCommon::ReportFrameSent ()
+{
+    uint32_t Now = micros ();
+
+    FrameTiming_t & Entry = TimingHistory[TimingHistoryCount % OUTPUT_TIMING_HISTORY_SIZE];
+    Entry.BuildUs    = SaturateTo16 (FrameBuiltTimeInMicroSec - FrameStartTimeInMicroSec);
+    Entry.TransmitUs = SaturateTo16 (Now - FrameBuiltTimeInMicroSec);
+    Entry.GapUs      = (0 == TimingHistoryCount) ? 0 : (FrameStartTimeInMicroSec - LastFrameEndTimeInMicroSec);
+    Entry.IsrUs      = SaturateTo16 (FrameIsrMicroSec);
+    TimingHistoryCount++;
+
+    // the frame has to be out before the next one is due
+    uint32_t DeadlineMicroSec = max (FrameDurationInMicroSec, OutputMgr.GetFrameTickPeriodMicroSec ());
+    if ((Now - FrameStartTimeInMicroSec) > DeadlineMicroSec)
+    {
+        MissedDeadlines++;
+    }
+
+    LastFrameEndTimeInMicroSec = Now;
+
+    // all of the frame data has been read
+    ReleaseFrontBuffer ();
+
+} // ReportFrameSent
+
+//----------------------------------------------------------------------------
+/*
+*   The drivers read the frame out of the buffer while it is being sent, so
+*   the double buffer bank they start with must not be handed back to the
+*   inputs until they are done with it.
+*/
+uint8_t * c_OutputCommon::LatchFrontBuffer ()
+{
+    // DEBUG_START;
+
+    uint8_t * Response = pOutputBuffer;
+
+    // a frame that was cut short never reported that it was sent
+    ReleaseFrontBuffer ();
+
+    if (nullptr != pFrameBanks[0])
+    {
+        uint32_t Bank = OutputMgr.LatchFrameBank ();
+        LatchedFrameBank = Bank;
+        Response = pFrameBanks[Bank];
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // LatchFrontBuffer
+
 //----------------------------------------------------------------------------
 bool c_OutputCommon::SetConfig (JsonObject & jsonConfig)
 {
@@ -91,6 +224,9 @@ bool c_OutputCommon::SetConfig (JsonObject & jsonConfig)
     DataPin = gpio_num_t (tempDataPin);
     // DEBUG_V(String(" DataPin: ") + String(DataPin));
 
+    // the new config may change what gets sent
+    MarkDirty ();
+
     // DEBUG_END;
 
     return response;
@@ -125,7 +261,8 @@ void c_OutputCommon::WriteChannelData (uint32_t StartChannelId, uint32_t Channel
     {
         // DEBUG_V(String("               StartChannelId: 0x") + String(StartChannelId, HEX));
         // DEBUG_V(String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
-        memcpy(&pOutputBuffer[StartChannelId], pSourceData, ChannelCount);
+        memcpy(&pBackBuffer[StartChannelId], pSourceData, ChannelCount);
+        MarkDirty ();
     }
 
     // DEBUG_END;
@@ -139,7 +276,7 @@ void c_OutputCommon::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCo
 
     // DEBUG_V(String("               StartChannelId: 0x") + String(StartChannelId, HEX));
     // DEBUG_V(String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
-    memcpy(pTargetData, &pOutputBuffer[StartChannelId], ChannelCount);
+    memcpy(pTargetData, &pBackBuffer[StartChannelId], ChannelCount);
 
     // DEBUG_END;
 
@@ -162,6 +299,10 @@ bool c_OutputCommon::ValidateGpio (gpio_num_t ConsoleTxGpio, gpio_num_t ConsoleR
     // DEBUG_START;
 
     FrameCount = 0;
+    TickOffsetMaxMicroSec = 0;
+    TickJitterMicroSec    = 0;
+    TimingHistoryCount    = 0;
+    MissedDeadlines       = 0;
     
     // DEBUG_END;
  } // ClearStatistics
@@ -147,6 +147,11 @@ bool c_OutputGECERmt::RmtPoll ()
             break;
         }
 
+        if (!canRefresh())
+        {
+            break;
+        }
+
         // DEBUG_V("get the next frame started");
         ReportNewFrame ();
         Response = Rmt.StartNewFrame ();
@@ -157,6 +157,11 @@ bool c_OutputGS8208Rmt::RmtPoll ()
             break;
         }
 
+        if (!canRefresh())
+        {
+            break;
+        }
+
         // DEBUG_V("get the next frame started");
         ReportNewFrame ();
         Response = Rmt.StartNewFrame ();
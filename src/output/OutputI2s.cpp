@@ -0,0 +1,519 @@
+/*
+* OutputI2s.cpp - I2S parallel driver code for ESPixelStick
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2015, 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+#include "ESPixelStick.h"
+#if defined(SUPPORT_I2S_OUTPUT)
+
+#include "output/OutputI2s.hpp"
+#include <driver/periph_ctrl.h>
+#include <esp_rom_gpio.h>
+#include <esp_heap_caps.h>
+#include <soc/i2s_struct.h>
+#include <soc/gpio_sig_map.h>
+
+// a frame that takes longer than this is abandoned by the send task
+#define I2S_FRAME_TIMEOUT_MS    1000
+
+c_OutputI2s OutputI2s;
+
+static TaskHandle_t SendFrameTaskHandle = NULL;
+
+//----------------------------------------------------------------------------
+static void IRAM_ATTR I2S_IsrHandler (void * arg)
+{
+    ((c_OutputI2s*)arg)->ISR_Handler ();
+} // I2S_IsrHandler
+
+//----------------------------------------------------------------------------
+// Send task. Starts a frame on all lanes that are ready and then waits for
+// the ISR to report that the frame is out.
+void I2S_Task (void *arg)
+{
+    (void)arg;
+    while (1)
+    {
+        if (OutputI2s.StartNewFrame ())
+        {
+            if (0 == ulTaskNotifyTake (pdTRUE, pdMS_TO_TICKS (I2S_FRAME_TIMEOUT_MS)))
+            {
+                // the end of frame interrupt never came
+                OutputI2s.AbortFrame ();
+            }
+        }
+        else
+        {
+            // nothing to send. Check again on the next tick
+            vTaskDelay (pdMS_TO_TICKS (1));
+        }
+    }
+} // I2S_Task
+
+//----------------------------------------------------------------------------
+c_OutputI2s::c_OutputI2s ()
+{
+    memset ((void *)&DmaDescriptors[0], 0x00, sizeof (DmaDescriptors));
+    memset ((void *)&LaneData[0][0],    0x00, sizeof (LaneData));
+    memset ((void *)&ActiveLanes[0],    0x00, sizeof (ActiveLanes));
+} // c_OutputI2s
+
+//----------------------------------------------------------------------------
+c_OutputI2s::~c_OutputI2s ()
+{
+    // the engine lives for the life of the application
+} // ~c_OutputI2s
+
+//----------------------------------------------------------------------------
+// Allocate the DMA buffers and set up I2S0 for 16 bit LCD mode. Runs once,
+// when the first lane registers.
+void c_OutputI2s::Begin ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (HasBeenInitialized)
+        {
+            break;
+        }
+
+        bool BuffersAllocated = true;
+        for (uint32_t BufferId = 0; BufferId < I2S_NUM_DMA_BUFFERS; ++BufferId)
+        {
+            pDmaBuffers[BufferId] = (uint16_t *)heap_caps_malloc (I2S_WORDS_PER_BUFFER * sizeof (uint16_t), MALLOC_CAP_DMA);
+            if (nullptr == pDmaBuffers[BufferId])
+            {
+                BuffersAllocated = false;
+                break;
+            }
+            memset (pDmaBuffers[BufferId], 0x00, I2S_WORDS_PER_BUFFER * sizeof (uint16_t));
+
+            // the descriptors form a ring. Each one raises an EOF interrupt when it has been sent
+            lldesc_t & Descriptor   = DmaDescriptors[BufferId];
+            Descriptor.size         = I2S_WORDS_PER_BUFFER * sizeof (uint16_t);
+            Descriptor.length       = I2S_WORDS_PER_BUFFER * sizeof (uint16_t);
+            Descriptor.buf          = (uint8_t *)pDmaBuffers[BufferId];
+            Descriptor.eof          = 1;
+            Descriptor.owner        = 1;
+            Descriptor.qe.stqe_next = &DmaDescriptors[(BufferId + 1) % I2S_NUM_DMA_BUFFERS];
+        }
+
+        if (!BuffersAllocated)
+        {
+            logcon (String (CN_stars) + F (" Could not allocate the I2S DMA buffers ") + CN_stars);
+            break;
+        }
+
+        periph_module_enable (PERIPH_I2S0_MODULE);
+
+        // reset the transmitter, the DMA and the FIFO
+        I2S0.conf.tx_reset          = 1;
+        I2S0.conf.tx_reset          = 0;
+        I2S0.lc_conf.out_rst        = 1;
+        I2S0.lc_conf.out_rst        = 0;
+        I2S0.lc_conf.ahbm_rst       = 1;
+        I2S0.lc_conf.ahbm_rst       = 0;
+        I2S0.lc_conf.ahbm_fifo_rst  = 1;
+        I2S0.lc_conf.ahbm_fifo_rst  = 0;
+        I2S0.conf.tx_fifo_reset     = 1;
+        I2S0.conf.tx_fifo_reset     = 0;
+
+        // 16 bit parallel output
+        I2S0.conf2.val              = 0;
+        I2S0.conf2.lcd_en           = 1;
+        I2S0.conf2.lcd_tx_wrx2_en   = 0;
+        I2S0.conf2.lcd_tx_sdx2_en   = 0;
+
+        // slot rate = 80MHz / (div_num + div_b / div_a)
+        I2S0.clkm_conf.val          = 0;
+        I2S0.clkm_conf.clka_en      = 0;
+        I2S0.clkm_conf.clkm_div_num = I2S_LCD_BASE_CLOCK_HZ / I2S_SLOT_RATE_HZ;
+        I2S0.clkm_conf.clkm_div_b   = 0;
+        I2S0.clkm_conf.clkm_div_a   = 1;
+
+        I2S0.sample_rate_conf.val            = 0;
+        I2S0.sample_rate_conf.tx_bits_mod    = 16;
+        I2S0.sample_rate_conf.tx_bck_div_num = 1;
+
+        I2S0.fifo_conf.val                   = 0;
+        I2S0.fifo_conf.tx_fifo_mod_force_en  = 1;
+        I2S0.fifo_conf.tx_fifo_mod           = 1;   // 16 bit single channel
+        I2S0.fifo_conf.tx_data_num           = 32;
+        I2S0.fifo_conf.dscr_en               = 1;
+
+        I2S0.conf1.val              = 0;
+        I2S0.conf1.tx_stop_en       = 0;
+        I2S0.conf1.tx_pcm_bypass    = 1;
+
+        I2S0.conf_chan.val          = 0;
+        I2S0.conf_chan.tx_chan_mod  = 1;
+
+        I2S0.timing.val             = 0;
+
+        I2S0.int_ena.val            = 0;
+        I2S0.int_clr.val            = 0xffffffff;
+
+        if (ESP_OK != esp_intr_alloc (ETS_I2S0_INTR_SOURCE, 0, I2S_IsrHandler, this, &IsrHandle))
+        {
+            logcon (String (CN_stars) + F (" Could not allocate the I2S interrupt ") + CN_stars);
+            break;
+        }
+
+        if (!SendFrameTaskHandle)
+        {
+            xTaskCreatePinnedToCore (I2S_Task, "I2S_Task", 4096, NULL, 5, &SendFrameTaskHandle, 1);
+        }
+
+        HasBeenInitialized = true;
+
+    } while (false);
+
+    // DEBUG_END;
+} // Begin
+
+//----------------------------------------------------------------------------
+void c_OutputI2s::RegisterLane (uint32_t Lane, gpio_num_t DataPin, uint32_t InterFrameGapMicroSec, c_OutputPixel * pPixelDataSource, c_OutputCommon * pParent)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if ((Lane >= I2S_MAX_LANES) || (nullptr == pPixelDataSource) || (nullptr == pParent))
+        {
+            logcon (String (CN_stars) + F (" Invalid I2S lane configuration ") + CN_stars);
+            break;
+        }
+
+        Begin ();
+        if (!HasBeenInitialized)
+        {
+            break;
+        }
+
+        // drop any previous registration (and its GPIO) for this lane
+        UnregisterLane (Lane);
+
+        Lanes[Lane].pPixelDataSource      = pPixelDataSource;
+        Lanes[Lane].pParent               = pParent;
+        Lanes[Lane].DataPin               = DataPin;
+        Lanes[Lane].InterFrameGapMicroSec = InterFrameGapMicroSec;
+
+        ResetGpio (DataPin);
+        esp_rom_gpio_pad_select_gpio (DataPin);
+        gpio_set_direction (DataPin, GPIO_MODE_OUTPUT);
+        esp_rom_gpio_connect_out_signal (DataPin, I2S_FIRST_LANE_SIGNAL + Lane, false, false);
+
+        RegisteredLanes |= uint16_t (1 << Lane);
+        UpdateIdleBuffersNeeded ();
+
+    } while (false);
+
+    // DEBUG_END;
+} // RegisterLane
+
+//----------------------------------------------------------------------------
+void c_OutputI2s::UnregisterLane (uint32_t Lane)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if ((Lane >= I2S_MAX_LANES) || (0 == (RegisteredLanes & (1 << Lane))))
+        {
+            break;
+        }
+
+        RegisteredLanes &= uint16_t (~(1 << Lane));
+
+        // the ISR may still be pulling data from this lane
+        uint32_t StartTimeMs = millis ();
+        while (FrameInProgress && ((millis () - StartTimeMs) < I2S_FRAME_TIMEOUT_MS))
+        {
+            delay (1);
+        }
+
+        // the frame did not end in time. The lane is still in FrameLanes, so
+        // stop the frame with the interrupt masked before the lane is cleared
+        if (FrameInProgress)
+        {
+            AbortFrame ();
+        }
+
+        ResetGpio (Lanes[Lane].DataPin);
+        Lanes[Lane] = Lane_t ();
+        UpdateIdleBuffersNeeded ();
+
+    } while (false);
+
+    // DEBUG_END;
+} // UnregisterLane
+
+//----------------------------------------------------------------------------
+// The line has to stay low for the longest inter frame gap of any lane.
+void c_OutputI2s::UpdateIdleBuffersNeeded ()
+{
+    uint32_t MaxGapMicroSec = 0;
+    for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+    {
+        if (RegisteredLanes & (1 << Lane))
+        {
+            MaxGapMicroSec = max (MaxGapMicroSec, Lanes[Lane].InterFrameGapMicroSec);
+        }
+    }
+
+    NumIdleBuffersNeeded = max (uint32_t (1), (MaxGapMicroSec + I2S_BUFFER_TIME_US - 1) / I2S_BUFFER_TIME_US);
+} // UpdateIdleBuffersNeeded
+
+//----------------------------------------------------------------------------
+void c_OutputI2s::GetStatus (ArduinoJson::JsonObject & jsonStatus)
+{
+    JsonObject I2sStatus = jsonStatus[F ("I2S")].to<JsonObject> ();
+    I2sStatus[F ("Lanes")]             = __builtin_popcount (RegisteredLanes);
+    I2sStatus[F ("FrameCount")]        = FrameCount;
+    I2sStatus[F ("FrameLatencyUs")]    = FrameLatencyMicroSec;
+    I2sStatus[F ("MaxFrameLatencyUs")] = MaxFrameLatencyMicroSec;
+    I2sStatus[F ("DescriptorErrors")]  = DescriptorErrors;
+    I2sStatus[F ("FrameTimeouts")]     = FrameTimeouts;
+} // GetStatus
+
+//----------------------------------------------------------------------------
+// Start a frame on every registered lane whose driver is ready. Returns true
+// if the DMA was started.
+bool c_OutputI2s::StartNewFrame ()
+{
+    bool Response = false;
+
+    do // once
+    {
+        if (FrameInProgress || (0 == RegisteredLanes))
+        {
+            break;
+        }
+
+        uint16_t NewFrameLanes = 0;
+        for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+        {
+            if ((RegisteredLanes & (1 << Lane)) && Lanes[Lane].pParent->I2sPoll ())
+            {
+                NewFrameLanes |= uint16_t (1 << Lane);
+            }
+        }
+
+        if (0 == NewFrameLanes)
+        {
+            break;
+        }
+        FrameLanes = NewFrameLanes;
+
+        // prime both buffers before the DMA starts
+        NumIdleBuffersSent = 0;
+        for (uint32_t BufferId = 0; BufferId < I2S_NUM_DMA_BUFFERS; ++BufferId)
+        {
+            ISR_FillBuffer (BufferId);
+        }
+
+        for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+        {
+            if (FrameLanes & (1 << Lane))
+            {
+                Lanes[Lane].pParent->ReportFrameBuilt ();
+            }
+        }
+
+        FrameKickoffMicroSec = micros ();
+        FrameInProgress = true;
+
+        I2S0.lc_conf.out_rst        = 1;
+        I2S0.lc_conf.out_rst        = 0;
+        I2S0.conf.tx_fifo_reset     = 1;
+        I2S0.conf.tx_fifo_reset     = 0;
+        I2S0.out_link.addr          = uint32_t (&DmaDescriptors[0]);
+        I2S0.int_clr.val            = 0xffffffff;
+        I2S0.int_ena.out_eof        = 1;
+        I2S0.int_ena.out_dscr_err   = 1;
+        I2S0.out_link.start         = 1;
+        I2S0.conf.tx_start          = 1;
+
+        Response = true;
+
+    } while (false);
+
+    return Response;
+} // StartNewFrame
+
+//----------------------------------------------------------------------------
+// Pull the next block of intensities from every lane in the frame and encode
+// them into a DMA buffer. Lanes that have run out of data stay low.
+void IRAM_ATTR c_OutputI2s::ISR_FillBuffer (uint32_t BufferId)
+{
+    uint16_t * pWords = pDmaBuffers[BufferId];
+    uint32_t   MaxCount = 0;
+
+    memset (ActiveLanes, 0x00, sizeof (ActiveLanes));
+
+    for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+    {
+        uint16_t LaneBit = uint16_t (1 << Lane);
+        if (0 == (FrameLanes & LaneBit))
+        {
+            continue;
+        }
+
+        c_OutputPixel * pSource = Lanes[Lane].pPixelDataSource;
+        uint32_t Count = pSource->ISR_MoreDataToSend () ? pSource->ISR_GetNextIntensitiesToSend (IntensityValues, I2S_INTENSITIES_PER_BUFFER) : 0;
+        for (uint32_t Index = 0; Index < Count; ++Index)
+        {
+            LaneData[Index][Lane] = uint8_t (IntensityValues[Index]);
+            ActiveLanes[Index] |= LaneBit;
+        }
+        MaxCount = max (MaxCount, Count);
+    }
+
+    for (uint32_t Index = 0; Index < MaxCount; ++Index)
+    {
+        I2sEncodeWS2811 (LaneData[Index], ActiveLanes[Index], &pWords[Index * I2S_WORDS_PER_INTENSITY], true);
+    }
+
+    if (MaxCount < I2S_INTENSITIES_PER_BUFFER)
+    {
+        memset (&pWords[MaxCount * I2S_WORDS_PER_INTENSITY], 0x00, (I2S_INTENSITIES_PER_BUFFER - MaxCount) * I2S_WORDS_PER_INTENSITY * sizeof (uint16_t));
+    }
+
+    BufferIsIdle[BufferId] = (0 == MaxCount);
+    DmaDescriptors[BufferId].owner = 1;
+} // ISR_FillBuffer
+
+//----------------------------------------------------------------------------
+void IRAM_ATTR c_OutputI2s::ISR_Handler ()
+{
+    uint32_t StartTime = micros ();
+
+    bool EndOfBuffer     = I2S0.int_st.out_eof;
+    bool DescriptorError = I2S0.int_st.out_dscr_err;
+    I2S0.int_clr.val     = I2S0.int_st.val;
+
+    uint16_t IsrLanes = FrameLanes;
+
+    do // once
+    {
+        if (!FrameInProgress)
+        {
+            break;
+        }
+
+        if (DescriptorError)
+        {
+            ++DescriptorErrors;
+            ISR_EndFrame ();
+            break;
+        }
+
+        if (!EndOfBuffer)
+        {
+            break;
+        }
+
+        // the DMA has moved on to the other buffer. Refill the one it just sent.
+        uint32_t BufferId = (I2S0.out_eof_des_addr == uint32_t (&DmaDescriptors[0])) ? 0 : 1;
+
+        if (BufferIsIdle[BufferId])
+        {
+            // the line has been low for a whole buffer
+            if (++NumIdleBuffersSent >= NumIdleBuffersNeeded)
+            {
+                ISR_EndFrame ();
+                break;
+            }
+        }
+
+        ISR_FillBuffer (BufferId);
+
+    } while (false);
+
+    uint32_t IsrMicroSec = micros () - StartTime;
+    for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+    {
+        if (IsrLanes & (1 << Lane))
+        {
+            Lanes[Lane].pParent->ReportIsrTime (IsrMicroSec);
+        }
+    }
+} // ISR_Handler
+
+//----------------------------------------------------------------------------
+void IRAM_ATTR c_OutputI2s::ISR_EndFrame ()
+{
+    I2S0.conf.tx_start  = 0;
+    I2S0.out_link.stop  = 1;
+    I2S0.int_ena.val    = 0;
+
+    FrameLatencyMicroSec    = micros () - FrameKickoffMicroSec;
+    MaxFrameLatencyMicroSec = max (MaxFrameLatencyMicroSec, FrameLatencyMicroSec);
+    ++FrameCount;
+
+    for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+    {
+        if (FrameLanes & (1 << Lane))
+        {
+            Lanes[Lane].pParent->ReportFrameSent ();
+        }
+    }
+
+    FrameInProgress = false;
+
+    if (SendFrameTaskHandle)
+    {
+        BaseType_t HigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR (SendFrameTaskHandle, &HigherPriorityTaskWoken);
+        if (pdFALSE != HigherPriorityTaskWoken)
+        {
+            portYIELD_FROM_ISR ();
+        }
+    }
+} // ISR_EndFrame
+
+//----------------------------------------------------------------------------
+// Runs in the send task when a frame has not ended in time. Stops the DMA so
+// that the next frame can start. The lanes never report this frame as sent.
+void c_OutputI2s::AbortFrame ()
+{
+    // DEBUG_START;
+
+    // the ISR runs on this core, so it is out of the way once it is disabled
+    I2S0.int_ena.val    = 0;
+    I2S0.conf.tx_start  = 0;
+    I2S0.out_link.stop  = 1;
+
+    if (FrameInProgress)
+    {
+        ++FrameTimeouts;
+
+        for (uint32_t Lane = 0; Lane < I2S_MAX_LANES; ++Lane)
+        {
+            if (FrameLanes & (1 << Lane))
+            {
+                Lanes[Lane].pParent->ReleaseFrontBuffer ();
+            }
+        }
+
+        FrameInProgress = false;
+    }
+
+    // DEBUG_END;
+} // AbortFrame
+
+#endif // defined(SUPPORT_I2S_OUTPUT)
@@ -42,6 +42,7 @@
 #include "output/OutputUCS1903Uart.hpp"
 #include "output/OutputWS2801Spi.hpp"
 #include "output/OutputWS2811Rmt.hpp"
+#include "output/OutputWS2811I2s.hpp"
 #include "output/OutputWS2811Uart.hpp"
 #include "output/OutputGS8208Uart.hpp"
 #include "output/OutputGS8208Rmt.hpp"
@@ -188,6 +189,71 @@ static const OutputChannelIdToGpioAndPortEntry_t OutputChannelIdToGpioAndPort[]
     {DEFAULT_RMT_7_GPIO, uart_port_t(7), c_OutputMgr::OM_PortType_t::Rmt},
 #endif // def DEFAULT_RMT_7_GPIO
 
+    // I2S parallel lanes. The port id is the lane number
+#ifdef DEFAULT_I2S_0_GPIO
+    {DEFAULT_I2S_0_GPIO, uart_port_t(0), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_0_GPIO
+
+#ifdef DEFAULT_I2S_1_GPIO
+    {DEFAULT_I2S_1_GPIO, uart_port_t(1), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_1_GPIO
+
+#ifdef DEFAULT_I2S_2_GPIO
+    {DEFAULT_I2S_2_GPIO, uart_port_t(2), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_2_GPIO
+
+#ifdef DEFAULT_I2S_3_GPIO
+    {DEFAULT_I2S_3_GPIO, uart_port_t(3), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_3_GPIO
+
+#ifdef DEFAULT_I2S_4_GPIO
+    {DEFAULT_I2S_4_GPIO, uart_port_t(4), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_4_GPIO
+
+#ifdef DEFAULT_I2S_5_GPIO
+    {DEFAULT_I2S_5_GPIO, uart_port_t(5), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_5_GPIO
+
+#ifdef DEFAULT_I2S_6_GPIO
+    {DEFAULT_I2S_6_GPIO, uart_port_t(6), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_6_GPIO
+
+#ifdef DEFAULT_I2S_7_GPIO
+    {DEFAULT_I2S_7_GPIO, uart_port_t(7), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_7_GPIO
+
+#ifdef DEFAULT_I2S_8_GPIO
+    {DEFAULT_I2S_8_GPIO, uart_port_t(8), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_8_GPIO
+
+#ifdef DEFAULT_I2S_9_GPIO
+    {DEFAULT_I2S_9_GPIO, uart_port_t(9), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_9_GPIO
+
+#ifdef DEFAULT_I2S_10_GPIO
+    {DEFAULT_I2S_10_GPIO, uart_port_t(10), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_10_GPIO
+
+#ifdef DEFAULT_I2S_11_GPIO
+    {DEFAULT_I2S_11_GPIO, uart_port_t(11), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_11_GPIO
+
+#ifdef DEFAULT_I2S_12_GPIO
+    {DEFAULT_I2S_12_GPIO, uart_port_t(12), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_12_GPIO
+
+#ifdef DEFAULT_I2S_13_GPIO
+    {DEFAULT_I2S_13_GPIO, uart_port_t(13), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_13_GPIO
+
+#ifdef DEFAULT_I2S_14_GPIO
+    {DEFAULT_I2S_14_GPIO, uart_port_t(14), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_14_GPIO
+
+#ifdef DEFAULT_I2S_15_GPIO
+    {DEFAULT_I2S_15_GPIO, uart_port_t(15), c_OutputMgr::OM_PortType_t::I2s},
+#endif // def DEFAULT_I2S_15_GPIO
+
 #ifdef SUPPORT_SPI_OUTPUT
     {DEFAULT_SPI_DATA_GPIO, uart_port_t(-1), c_OutputMgr::OM_PortType_t::Spi},
 #endif
@@ -258,6 +324,11 @@ void c_OutputMgr::Begin ()
 
         HasBeenInitialized = true;
 
+#if defined(ARDUINO_ARCH_ESP32)
+        // recursive so that ClearBuffer can hold it across its own publish
+        PublishFrameLock = xSemaphoreCreateRecursiveMutex ();
+#endif // defined(ARDUINO_ARCH_ESP32)
+
 #ifdef LED_FLASH_GPIO
         ResetGpio(LED_FLASH_GPIO);
         pinMode (LED_FLASH_GPIO, OUTPUT);
@@ -280,7 +351,7 @@ void c_OutputMgr::Begin ()
         // CreateNewConfig();
 
         // Preset the output memory
-        memset((void*)&OutputBuffer[0], 0x00, sizeof(OutputBuffer));
+        ClearBuffer();
 
     } while (false);
 
@@ -297,6 +368,10 @@ void c_OutputMgr::CreateJsonConfig (JsonObject& jsonConfig)
 
     // add OM config parameters
     // DEBUG_V ();
+    JsonWrite(jsonConfig, CN_DoubleBuffer, DoubleBufferEnabled);
+    JsonWrite(jsonConfig, CN_Interpolate,  InterpolationEnabled);
+    JsonWrite(jsonConfig, CN_KeepAliveMs,  KeepAliveIntervalMs);
+    JsonWrite(jsonConfig, CN_FrameRate,    FrameRate);
 
     // add the channels header
     JsonObject OutputMgrChannelsData = jsonConfig[(char*)CN_channels];
@@ -387,7 +462,7 @@ void c_OutputMgr::CreateNewConfig ()
     // DEBUG_V ();
 
     JsonWrite(JsonConfig, CN_cfgver,      ConstConfig.CurrentConfigVersion);
-    JsonWrite(JsonConfig, CN_MaxChannels, sizeof(OutputBuffer));
+    JsonWrite(JsonConfig, CN_MaxChannels, OM_MAX_TOTAL_CHANNELS);
 
     // DEBUG_V("Collect the all ports disabled config first");
     CreateJsonConfig (JsonConfig);
@@ -489,6 +564,25 @@ void c_OutputMgr::GetStatus (JsonObject & jsonStatus)
         // DEBUG_V ();
     }
 
+    if (IsDoubleBuffered ())
+    {
+        JsonObject HandoffStatus = jsonStatus[F ("FrameHandoff")].to<JsonObject> ();
+        JsonWrite(HandoffStatus, F("Published"), FrameHandoff.GetPublishedSequence ());
+        JsonWrite(HandoffStatus, F("Sending"),   FrameHandoff.GetFrontSequence ());
+        JsonWrite(HandoffStatus, F("Dropped"),   FrameHandoff.GetDroppedFrames ());
+        JsonWrite(HandoffStatus, F("Deferred"),  FrameHandoff.GetDeferredTakes ());
+    }
+
+    if (CaptureIdle != CaptureState)
+    {
+        JsonObject CaptureStatus = jsonStatus[(char*)CN_capture].to<JsonObject> ();
+        JsonWrite(CaptureStatus, CN_state,    (CaptureRecording == CaptureState) ? F("recording") : F("replaying"));
+        JsonWrite(CaptureStatus, CN_file,     CaptureFileName);
+        JsonWrite(CaptureStatus, CN_count,    CaptureFrameCount);
+        JsonWrite(CaptureStatus, F("NumFrames"), CaptureNumFrames);
+        JsonWrite(CaptureStatus, F("FrameSize"), CaptureFrameSize);
+    }
+
     // DEBUG_END;
 } // GetStatus
 
@@ -784,6 +878,16 @@ void c_OutputMgr::InstantiateNewOutputChannel(DriverInfo_t & CurrentOutput, e_Ou
                 }
                 #endif // defined(ARDUINO_ARCH_ESP32)
 
+                #if defined(SUPPORT_I2S_OUTPUT)
+                if (OM_IS_I2S)
+                {
+                    // DEBUG_V ("I2S");
+                    AllocatePort(c_OutputWS2811I2s,CurrentOutput,CurrentOutput.DriverId,CurrentOutput.GpioPin,CurrentOutput.PortId,OutputType_WS2811);
+                    // DEBUG_V ();
+                    break;
+                }
+                #endif // defined(SUPPORT_I2S_OUTPUT)
+
                 if (!BuildingNewConfig)
                 {
                     logcon(CN_stars + String(F(" Cannot Start WS2811 for channel '")) + CurrentOutput.DriverId + "'. " + CN_stars);
@@ -1166,6 +1270,19 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
 
     do // once
     {
+        JsonObject OutputChannelMgrData = jsonConfig[(char*)CN_output_config];
+        if (OutputChannelMgrData)
+        {
+            setFromJSON (DoubleBufferEnabled, OutputChannelMgrData, CN_DoubleBuffer);
+            setFromJSON (InterpolationEnabled, OutputChannelMgrData, CN_Interpolate);
+            setFromJSON (KeepAliveIntervalMs, OutputChannelMgrData, CN_KeepAliveMs);
+            setFromJSON (FrameRate,           OutputChannelMgrData, CN_FrameRate);
+        }
+
+        FrameRate = min (FrameRate, uint32_t (OM_MAX_FRAME_RATE));
+        FrameTickPeriodMicroSec = (0 == FrameRate) ? 0 : (MicroSecondsInASecond / FrameRate);
+        // DEBUG_V (String ("FrameTickPeriodMicroSec: ") + String (FrameTickPeriodMicroSec));
+
         // for each output channel
         for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
         {
@@ -1235,6 +1352,7 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
     }
 
     // DEBUG_V ();
+    UpdateDoubleBuffer ();
     UpdateDisplayBufferReferences ();
     // DEBUG_V ();
 
@@ -1369,87 +1487,31 @@ void c_OutputMgr::Poll()
 
     if ((false == OutputIsPaused) && (false == ConfigInProgress) && (false == RebootInProgress()) )
     {
+        if (IsDoubleBuffered ())
+        {
+            TakeFrame ();
+        }
+
+        if (nullptr != pInterpolationOutput)
+        {
+            Interpolate ();
+        }
+
         // //DEBUG_V();
         for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
         {
             // //DEBUG_V("Poll a channel");
             ((c_OutputCommon*)CurrentOutput.OutputDriver)->Poll ();
         }
-    }
-
-    // //DEBUG_END;
-} // Poll
-
-//-----------------------------------------------------------------------------
-void c_OutputMgr::UpdateDisplayBufferReferences (void)
-{
-    // DEBUG_START;
 
-    /* Buffer vs virtual buffer.
-        Pixels have a concept called groups. A group of pixels uses
-        a single tupple of input channel data and replicates that
-        data into N positions in the output buffer. For non pixel
-        channels or for pixels with a group size of 1, the virtual
-        buffer and the output buffers are the same.
-        The virtual buffer size is the one we give to the input
-        processing engine
-    */
-    uint32_t OutputBufferOffset     = 0;    // offset into the raw data in the output buffer
-    uint32_t OutputChannelOffset    = 0;    // Virtual channel offset to the output buffer.
-
-    // DEBUG_V (String ("        BufferSize: ") + String (sizeof(OutputBuffer)));
-    // DEBUG_V (String ("OutputBufferOffset: ") + String (OutputBufferOffset));
-
-    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
-    {
-        // String DriverName;
-        // OutputChannel.pOutputChannelDriver->GetDriverName(DriverName);
-        // DEBUG_V(String("Name: ") + DriverName);
-        // DEBUG_V(String("PortId: ") + String(OutputChannel.pOutputChannelDriver->GetOutputChannelId()) );
-
-        CurrentOutput.OutputBufferStartingOffset = OutputBufferOffset;
-        CurrentOutput.OutputChannelStartingOffset = OutputChannelOffset;
-        ((c_OutputCommon*)CurrentOutput.OutputDriver)->SetOutputBufferAddress(&OutputBuffer[OutputBufferOffset]);
-
-        uint32_t OutputBufferDataBytesNeeded        = ((c_OutputCommon*)CurrentOutput.OutputDriver)->GetNumOutputBufferBytesNeeded ();
-        uint32_t VirtualOutputBufferDataBytesNeeded = ((c_OutputCommon*)CurrentOutput.OutputDriver)->GetNumOutputBufferChannelsServiced ();
-
-        uint32_t AvailableChannels = sizeof(OutputBuffer) - OutputBufferOffset;
-
-        if (AvailableChannels < OutputBufferDataBytesNeeded)
+        if ((CaptureIdle != CaptureState) || (CaptureRequestNone != CaptureRequest))
         {
-            logcon (MN_22 + String (OutputBufferDataBytesNeeded));
-            // DEBUG_V (String ("    ChannelsNeeded: ") + String (ChannelsNeeded));
-            // DEBUG_V (String (" AvailableChannels: ") + String (AvailableChannels));
-            // DEBUG_V (String ("ChannelsToAllocate: ") + String (ChannelsToAllocate));
-            break;
+            ProcessCapture ();
         }
-
-        // DEBUG_V (String ("    ChannelsNeeded: ") + String (OutputBufferDataBytesNeeded));
-        // DEBUG_V (String (" AvailableChannels: ") + String (AvailableChannels));
-
-        OutputBufferOffset += OutputBufferDataBytesNeeded;
-        CurrentOutput.OutputBufferDataSize  = OutputBufferDataBytesNeeded;
-        CurrentOutput.OutputBufferEndOffset = OutputBufferOffset - 1;
-        ((c_OutputCommon*)CurrentOutput.OutputDriver)->SetOutputBufferSize (OutputBufferDataBytesNeeded);
-
-        OutputChannelOffset += VirtualOutputBufferDataBytesNeeded;
-        CurrentOutput.OutputChannelSize      = VirtualOutputBufferDataBytesNeeded;
-        CurrentOutput.OutputChannelEndOffset = OutputChannelOffset;
-
-        // DEBUG_V (String("OutputChannel.GetBufferUsedSize: ") + String(OutputChannel.pOutputChannelDriver->GetBufferUsedSize()));
-        // DEBUG_V (String ("OutputBufferOffset: ") + String(OutputBufferOffset));
     }
 
-    // DEBUG_V (String ("   TotalBufferSize: ") + String (OutputBufferOffset));
-    UsedBufferSize = OutputBufferOffset;
-    // DEBUG_V (String ("       OutputBuffer: 0x") + String (uint32_t (OutputBuffer), HEX));
-    // DEBUG_V (String ("     UsedBufferSize: ") + String (uint32_t (UsedBufferSize)));
-    InputMgr.SetBufferInfo (UsedBufferSize);
-
-    // DEBUG_END;
-
-} // UpdateDisplayBufferReferences
+    // //DEBUG_END;
+} // Poll
 
 //-----------------------------------------------------------------------------
 void c_OutputMgr::RelayUpdate (uint8_t RelayId, String & NewValue, String & Response)
@@ -1495,139 +1557,500 @@ void c_OutputMgr::PauseOutputs(bool PauseTheOutput)
 } // PauseOutputs
 
 //-----------------------------------------------------------------------------
-void c_OutputMgr::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCount, uint8_t *pSourceData)
+void c_OutputMgr::StartCapture (const String & FileName, uint32_t NumFrames)
+{
+    // DEBUG_START;
+
+    CaptureRequestFileName  = FileName;
+    CaptureRequestNumFrames = NumFrames;
+    CaptureRequest          = CaptureRequestRecord;
+
+    // DEBUG_END;
+
+} // StartCapture
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::StartReplay (const String & FileName)
+{
+    // DEBUG_START;
+
+    CaptureRequestFileName = FileName;
+    CaptureRequest         = CaptureRequestReplay;
+
+    // DEBUG_END;
+
+} // StartReplay
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::StopCapture ()
+{
+    // DEBUG_START;
+
+    CaptureRequest = CaptureRequestStop;
+
+    // DEBUG_END;
+
+} // StopCapture
+
+//-----------------------------------------------------------------------------
+/*
+*   Called from Poll after the drivers have been serviced. The requests come
+*   from the web server task and are acted on here so that all of the file
+*   access happens in one place.
+*/
+void c_OutputMgr::ProcessCapture ()
 {
     // DEBUG_START;
 
     do // once
     {
-        if(OutputIsPaused)
+        CaptureRequest_t Request = CaptureRequest;
+        if (CaptureRequestNone != Request)
         {
-            // DEBUG_V("Ignore the write request");
+            CaptureRequest = CaptureRequestNone;
+            CloseCapture ();
+
+            CaptureOnSd     = FileMgr.SdCardIsInstalled ();
+            CaptureFileName = CaptureRequestFileName;
+            if (!CaptureOnSd && !CaptureFileName.startsWith ("/"))
+            {
+                CaptureFileName = String ("/") + CaptureFileName;
+            }
+
+            if (CaptureRequestRecord == Request)
+            {
+                CaptureNumFrames = CaptureRequestNumFrames;
+                BeginRecording ();
+            }
+            else if (CaptureRequestReplay == Request)
+            {
+                BeginReplay ();
+            }
             break;
         }
-        if (((StartChannelId + ChannelCount) > UsedBufferSize) || (0 == ChannelCount))
+
+        if (CaptureIdle == CaptureState)
         {
-            // DEBUG_V (String("ERROR: Invalid parameters"));
-            // DEBUG_V (String("StartChannelId: ") + String(StartChannelId));
-            // DEBUG_V (String("  ChannelCount: ") + String(ChannelCount));
-            // DEBUG_V (String("UsedBufferSize: ") + String(UsedBufferSize));
             break;
         }
 
-        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
-        uint32_t EndChannelId = StartChannelId + ChannelCount;
-        // Serial.print('1');
-        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        if (CaptureFrameSize != UsedBufferSize)
+        {
+            logcon (String (CN_stars) + F (" Output configuration changed. Capture of '") + CaptureFileName + F ("' stopped. ") + CN_stars);
+            CloseCapture ();
+            break;
+        }
+
+        uint32_t TimeOffsetMs = 0;
+        uint32_t RecordSize   = sizeof (TimeOffsetMs) + CaptureFrameSize;
+
+        if (CaptureRecording == CaptureState)
         {
-            // Serial.print('2');
-            // does this output handle this block of data?
-            if (StartChannelId < CurrentOutput.OutputChannelStartingOffset)
+            // one record for each frame the drivers have started
+            uint32_t DriverFrameCount = GetDriverFrameCount ();
+            if (DriverFrameCount == CaptureLastDriverFrames)
             {
-                // we have gone beyond where we can put this data.
-                // Serial.print('3');
                 break;
             }
+            CaptureLastDriverFrames = DriverFrameCount;
 
-            if (StartChannelId > CurrentOutput.OutputChannelEndOffset)
+            if (((CaptureBufferSize - CaptureBufferUsed) < RecordSize) && !FlushCaptureBuffer ())
             {
-                // move to the next driver
-                // Serial.print('4');
-                continue;
+                CloseCapture ();
+                break;
             }
-            // Serial.print('5');
-
-            uint32_t lastChannelToSet = min(EndChannelId, CurrentOutput.OutputChannelEndOffset);
-            uint32_t ChannelsToSet = lastChannelToSet - StartChannelId;
-            uint32_t RelativeStartChannelId = StartChannelId - CurrentOutput.OutputChannelStartingOffset;
-            // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
-            // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
-            // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
-            // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
-            if (ChannelsToSet)
+
+            TimeOffsetMs = millis () - CaptureStartMs;
+            memcpy (&pCaptureBuffer[CaptureBufferUsed], &TimeOffsetMs, sizeof (TimeOffsetMs));
+            ReadOutputBuffer (0, CaptureFrameSize, &pCaptureBuffer[CaptureBufferUsed + sizeof (TimeOffsetMs)]);
+            CaptureBufferUsed += RecordSize;
+
+            if (++CaptureFrameCount >= CaptureNumFrames)
             {
-                ((c_OutputCommon*)CurrentOutput.OutputDriver)->WriteChannelData(RelativeStartChannelId, ChannelsToSet, pSourceData);
+                CloseCapture ();
+            }
+            break;
+        }
+
+        // replaying. The next frame to send is already in the capture buffer
+        memcpy (&TimeOffsetMs, pCaptureBuffer, sizeof (TimeOffsetMs));
+        if (int32_t (millis () - CaptureStartMs) < int32_t (TimeOffsetMs))
+        {
+            break;
+        }
+
+        WriteOutputBuffer (0, CaptureFrameSize, &pCaptureBuffer[sizeof (TimeOffsetMs)]);
+        CommitFrame ();
+        CaptureFrameCount++;
+
+        if (!ReadReplayFrame ())
+        {
+            // start over. Give the last frame the average frame time
+            CaptureStartMs     += TimeOffsetMs + (TimeOffsetMs / max (uint32_t (1), CaptureNumFrames - 1));
+            CaptureFilePosition = CaptureHeaderSize;
+            if (!ReadReplayFrame ())
+            {
+                CloseCapture ();
             }
-            StartChannelId += ChannelsToSet;
-            pSourceData += ChannelsToSet;
-            // memcpy(&OutputBuffer[StartChannelId], pSourceData, ChannelCount);
         }
 
     } while (false);
+
     // DEBUG_END;
 
-} // WriteChannelData
+} // ProcessCapture
 
 //-----------------------------------------------------------------------------
-void c_OutputMgr::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData)
+bool c_OutputMgr::BeginRecording ()
 {
     // DEBUG_START;
 
+    bool Response = false;
+
     do // once
     {
-        if(OutputIsPaused)
+        if ((0 == UsedBufferSize) || (0 == CaptureNumFrames))
         {
-            // DEBUG_V("Ignore the read request");
+            logcon (String (CN_stars) + F (" Nothing to capture ") + CN_stars);
             break;
         }
-        if ((StartChannelId + ChannelCount) > UsedBufferSize)
+
+        if (CaptureOnSd)
+        {
+            FileMgr.DeleteSdFile (CaptureFileName);
+        }
+        else
+        {
+            FileMgr.DeleteFlashFile (CaptureFileName);
+        }
+
+        if (!OpenCapture (true))
+        {
+            break;
+        }
+
+        CaptureFrameSize  = UsedBufferSize;
+        CaptureHeaderSize = sizeof (CaptureHeader_t) + (OutputChannelId_End * sizeof (CaptureOutputInfo_t));
+        CaptureBufferSize = max (uint32_t (OM_CAPTURE_BUFFER_SIZE), uint32_t (sizeof (uint32_t) + CaptureFrameSize));
+        CaptureBufferSize = max (CaptureBufferSize, CaptureHeaderSize);
+        pCaptureBuffer    = (uint8_t*)malloc (CaptureBufferSize);
+        if (nullptr == pCaptureBuffer)
         {
-            // DEBUG_V (String("ERROR: Invalid parameters"));
-            // DEBUG_V (String("StartChannelId: ") + String(StartChannelId, HEX));
-            // DEBUG_V (String("  ChannelCount: ") + String(ChannelCount));
-            // DEBUG_V (String("UsedBufferSize: ") + String(UsedBufferSize));
+            logcon (String (CN_stars) + F (" Could not allocate the capture buffer ") + CN_stars);
             break;
         }
-        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
-        uint32_t EndChannelId = StartChannelId + ChannelCount;
-        // Serial.print('1');
+
+        // the frame count is filled in when the capture ends
+        CaptureHeader_t Header = {OM_CAPTURE_MAGIC, OM_CAPTURE_VERSION, uint16_t (CaptureHeaderSize), CaptureFrameSize, 0, OutputChannelId_End};
+        memcpy (pCaptureBuffer, &Header, sizeof (Header));
+        CaptureBufferUsed = sizeof (Header);
+
         for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
         {
-            // Serial.print('2');
-            // does this output handle this block of data?
-            if (StartChannelId < CurrentOutput.OutputChannelStartingOffset)
-            {
-                // we have gone beyond where we can put this data.
-                // Serial.print('3');
-                break;
-            }
+            CaptureOutputInfo_t Info;
+            Info.OutputType      = uint8_t (((c_OutputCommon*)CurrentOutput.OutputDriver)->GetOutputType ());
+            Info.OutputChannelId = uint8_t (CurrentOutput.DriverId);
+            Info.Reserved        = 0;
+            Info.BufferOffset    = CurrentOutput.OutputBufferStartingOffset;
+            Info.BufferSize      = CurrentOutput.OutputBufferDataSize;
+            Info.ChannelOffset   = CurrentOutput.OutputChannelStartingOffset;
+            Info.ChannelCount    = CurrentOutput.OutputChannelSize;
+            memcpy (&pCaptureBuffer[CaptureBufferUsed], &Info, sizeof (Info));
+            CaptureBufferUsed += sizeof (Info);
+        }
+
+        CaptureFrameCount       = 0;
+        CaptureLastDriverFrames = GetDriverFrameCount ();
+        CaptureStartMs          = millis ();
+        CaptureState            = CaptureRecording;
+
+        logcon (String (F ("Capturing ")) + String (CaptureNumFrames) + F (" frames of ") + String (CaptureFrameSize) +
+                F (" bytes to '") + CaptureFileName + "'");
+        Response = true;
+
+    } while (false);
+
+    if (!Response)
+    {
+        CloseCapture ();
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // BeginRecording
+
+//-----------------------------------------------------------------------------
+bool c_OutputMgr::BeginReplay ()
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        if (!OpenCapture (false))
+        {
+            break;
+        }
+
+        CaptureHeader_t Header;
+        if (!ReadCaptureData (0, (uint8_t*)&Header, sizeof (Header)) ||
+            (OM_CAPTURE_MAGIC != Header.Magic) ||
+            (OM_CAPTURE_VERSION != Header.Version))
+        {
+            logcon (String (CN_stars) + F (" '") + CaptureFileName + F ("' is not a frame capture ") + CN_stars);
+            break;
+        }
 
-            if (StartChannelId > CurrentOutput.OutputChannelEndOffset)
+        if (Header.FrameSize != UsedBufferSize)
+        {
+            logcon (String (CN_stars) + F (" '") + CaptureFileName + F ("' was captured with a different output configuration ") + CN_stars);
+            break;
+        }
+
+        // the same total size can still hide a different layout
+        for (uint32_t OutputIndex = 0; OutputIndex < min (Header.NumOutputs, uint32_t (OutputChannelId_End)); ++OutputIndex)
+        {
+            CaptureOutputInfo_t Info;
+            DriverInfo_t & CurrentOutput = OutputChannelDrivers[OutputIndex];
+            if (ReadCaptureData (sizeof (Header) + (OutputIndex * sizeof (Info)), (uint8_t*)&Info, sizeof (Info)) &&
+                ((Info.BufferOffset != CurrentOutput.OutputBufferStartingOffset) || (Info.BufferSize != CurrentOutput.OutputBufferDataSize)))
             {
-                // move to the next driver
-                // Serial.print('4');
-                continue;
+                logcon (String (F ("WARNING: Output ")) + String (OutputIndex) + F (" does not match the layout in '") + CaptureFileName + "'");
             }
-            // Serial.print('5');
-
-            uint32_t lastChannelToSet = min(EndChannelId, CurrentOutput.OutputChannelEndOffset);
-            uint32_t ChannelsToSet = lastChannelToSet - StartChannelId;
-            uint32_t RelativeStartChannelId = StartChannelId - CurrentOutput.OutputChannelStartingOffset;
-            // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
-            // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
-            // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
-            // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
-            ((c_OutputCommon*)CurrentOutput.OutputDriver)->ReadChannelData(RelativeStartChannelId, ChannelsToSet, pTargetData);
-            StartChannelId += ChannelsToSet;
-            pTargetData += ChannelsToSet;
-            // memcpy(&OutputBuffer[StartChannelId], pTargetData, ChannelCount);
         }
 
+        CaptureFrameSize  = Header.FrameSize;
+        CaptureHeaderSize = Header.HeaderSize;
+        CaptureNumFrames  = Header.NumFrames;
+        CaptureBufferSize = sizeof (uint32_t) + CaptureFrameSize;
+        pCaptureBuffer    = (uint8_t*)malloc (CaptureBufferSize);
+        if (nullptr == pCaptureBuffer)
+        {
+            logcon (String (CN_stars) + F (" Could not allocate the capture buffer ") + CN_stars);
+            break;
+        }
+
+        CaptureFilePosition = CaptureHeaderSize;
+        if (!ReadReplayFrame ())
+        {
+            logcon (String (CN_stars) + F (" '") + CaptureFileName + F ("' has no frames ") + CN_stars);
+            break;
+        }
+
+        CaptureFrameCount = 0;
+        CaptureStartMs    = millis ();
+        CaptureState      = CaptureReplaying;
+
+        logcon (String (F ("Replaying ")) + String (CaptureNumFrames) + F (" frames from '") + CaptureFileName + "'");
+        Response = true;
+
     } while (false);
+
+    if (!Response)
+    {
+        CloseCapture ();
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // BeginReplay
+
+//-----------------------------------------------------------------------------
+bool c_OutputMgr::ReadReplayFrame ()
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    if (CaptureFilePosition < (CaptureHeaderSize + (CaptureNumFrames * CaptureBufferSize)))
+    {
+        Response = ReadCaptureData (CaptureFilePosition, pCaptureBuffer, CaptureBufferSize);
+        CaptureFilePosition += CaptureBufferSize;
+    }
+
     // DEBUG_END;
+    return Response;
 
-} // ReadChannelData
+} // ReadReplayFrame
 
 //-----------------------------------------------------------------------------
-void c_OutputMgr::ClearBuffer()
+bool c_OutputMgr::FlushCaptureBuffer ()
 {
     // DEBUG_START;
 
-    memset(GetBufferAddress(), 0x00, OutputMgr.GetBufferSize());
+    bool Response = true;
+
+    if (CaptureBufferUsed)
+    {
+        Response = WriteCaptureData (pCaptureBuffer, CaptureBufferUsed);
+        CaptureBufferUsed = 0;
+    }
 
     // DEBUG_END;
+    return Response;
+
+} // FlushCaptureBuffer
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::CloseCapture ()
+{
+    // DEBUG_START;
+
+    bool Recording = (CaptureRecording == CaptureState);
+    if (Recording)
+    {
+        FlushCaptureBuffer ();
+    }
+    CloseCaptureFile ();
+
+    // now that the data is all there, record how much of it there is
+    if (Recording && OpenCapture (true))
+    {
+        CaptureHeader_t Header = {OM_CAPTURE_MAGIC, OM_CAPTURE_VERSION, uint16_t (CaptureHeaderSize), CaptureFrameSize, CaptureFrameCount, OutputChannelId_End};
+        WriteCaptureData ((uint8_t*)&Header, sizeof (Header));
+        CloseCaptureFile ();
+        logcon (String (F ("Captured ")) + String (CaptureFrameCount) + F (" frames to '") + CaptureFileName + "'");
+    }
+
+    if (nullptr != pCaptureBuffer)
+    {
+        free (pCaptureBuffer);
+        pCaptureBuffer = nullptr;
+    }
+    CaptureBufferSize = 0;
+    CaptureBufferUsed = 0;
+    CaptureState      = CaptureIdle;
+
+    // DEBUG_END;
+
+} // CloseCapture
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::CloseCaptureFile ()
+{
+    // DEBUG_START;
+
+    if (c_FileMgr::INVALID_FILE_HANDLE != CaptureSdFile)
+    {
+        FileMgr.CloseSdFile (CaptureSdFile);
+        CaptureSdFile = c_FileMgr::INVALID_FILE_HANDLE;
+    }
+
+    if (CaptureFlashFile)
+    {
+        CaptureFlashFile.close ();
+    }
+
+    // DEBUG_END;
+
+} // CloseCaptureFile
+
+//-----------------------------------------------------------------------------
+/*
+*   Opening for writing does not truncate the file and leaves the write
+*   position at the start of the file.
+*/
+bool c_OutputMgr::OpenCapture (bool ForWriting)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    if (CaptureOnSd)
+    {
+        Response = FileMgr.OpenSdFile (CaptureFileName,
+                                       ForWriting ? c_FileMgr::FileMode::FileWrite : c_FileMgr::FileMode::FileRead,
+                                       CaptureSdFile, -1);
+    }
+    else
+    {
+        const char * Mode = CN_r;
+        if (ForWriting)
+        {
+            Mode = LittleFS.exists (CaptureFileName) ? "r+" : "w";
+        }
+        CaptureFlashFile = LittleFS.open (CaptureFileName, Mode);
+        Response = bool (CaptureFlashFile);
+        if (!Response)
+        {
+            logcon (String (F ("ERROR: Could not open '")) + CaptureFileName + F ("'."));
+        }
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // OpenCapture
+
+//-----------------------------------------------------------------------------
+bool c_OutputMgr::WriteCaptureData (uint8_t * pData, uint32_t Length)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    if (CaptureOnSd)
+    {
+        Response = (Length == FileMgr.WriteSdFile (CaptureSdFile, pData, Length));
+    }
+    else
+    {
+        Response = (Length == CaptureFlashFile.write (pData, Length));
+    }
+
+    if (!Response)
+    {
+        logcon (String (CN_stars) + F (" Could not write to '") + CaptureFileName + F ("' ") + CN_stars);
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // WriteCaptureData
+
+//-----------------------------------------------------------------------------
+bool c_OutputMgr::ReadCaptureData (uint32_t Position, uint8_t * pData, uint32_t Length)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    if (CaptureOnSd)
+    {
+        Response = (Length == FileMgr.ReadSdFile (CaptureSdFile, pData, Length, Position));
+    }
+    else
+    {
+        Response = CaptureFlashFile.seek (Position) && (Length == CaptureFlashFile.read (pData, Length));
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // ReadCaptureData
+
+//-----------------------------------------------------------------------------
+uint32_t c_OutputMgr::GetDriverFrameCount ()
+{
+    // DEBUG_START;
+
+    uint32_t Response = 0;
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        if (CurrentOutput.OutputBufferDataSize)
+        {
+            Response += ((c_OutputCommon*)CurrentOutput.OutputDriver)->GetFrameCount ();
+        }
+    }
+
+    // DEBUG_END;
+    return Response;
 
-} // ClearBuffer
+} // GetDriverFrameCount
 
 // create a global instance of the output channel factory
 c_OutputMgr OutputMgr;
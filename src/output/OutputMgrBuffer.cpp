@@ -0,0 +1,904 @@
+/*
+* OutputMgrBuffer.cpp - Output buffer management and channel routing
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   The parts of the output manager that place the outputs in the output
+*   buffer, route the input channels to them and hand frames from the inputs
+*   to the drivers. Kept apart from the driver factory so that the host unit
+*   tests can build it without any of the drivers.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "output/OutputCommon.hpp"
+#include "output/OutputMgr.hpp"
+#include "input/InputMgr.hpp"
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::UpdateDisplayBufferReferences (void)
+{
+    // DEBUG_START;
+
+    /* Buffer vs virtual buffer.
+        Pixels have a concept called groups. A group of pixels uses
+        a single tupple of input channel data and replicates that
+        data into N positions in the output buffer. For non pixel
+        channels or for pixels with a group size of 1, the virtual
+        buffer and the output buffers are the same.
+        The virtual buffer size is the one we give to the input
+        processing engine
+
+       Internal vs overflow buffer.
+        The offsets seen by the inputs are contiguous. Physically
+        each output lives in either the internal buffer or the
+        overflow buffer. Outputs that are fed from an ISR get the
+        internal buffer first. Relays go last.
+    */
+    uint32_t OutputBufferOffset     = 0;    // offset into the raw data in the output buffer
+    uint32_t OutputChannelOffset    = 0;    // Virtual channel offset to the output buffer.
+    uint32_t InternalBufferOffset   = 0;
+    uint32_t OverflowBufferOffset   = 0;
+    bool     OverflowNeedsInternalRam = false;
+
+    // DEBUG_V (String ("        BufferSize: ") + String (sizeof(OutputBuffer)));
+    // DEBUG_V (String ("OutputBufferOffset: ") + String (OutputBufferOffset));
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        // String DriverName;
+        // OutputChannel.pOutputChannelDriver->GetDriverName(DriverName);
+        // DEBUG_V(String("Name: ") + DriverName);
+        // DEBUG_V(String("PortId: ") + String(OutputChannel.pOutputChannelDriver->GetOutputChannelId()) );
+
+        CurrentOutput.OutputBufferStartingOffset = OutputBufferOffset;
+        CurrentOutput.OutputChannelStartingOffset = OutputChannelOffset;
+        CurrentOutput.IdentityMapped = false;
+        CurrentOutput.InOverflowBuffer = false;
+        CurrentOutput.PhysicalBufferOffset = 0;
+
+        uint32_t OutputBufferDataBytesNeeded        = ((c_OutputCommon*)CurrentOutput.OutputDriver)->GetNumOutputBufferBytesNeeded ();
+        uint32_t VirtualOutputBufferDataBytesNeeded = ((c_OutputCommon*)CurrentOutput.OutputDriver)->GetNumOutputBufferChannelsServiced ();
+
+        uint32_t AvailableChannels = OM_MAX_TOTAL_CHANNELS - OutputBufferOffset;
+
+        if (AvailableChannels < OutputBufferDataBytesNeeded)
+        {
+            logcon (MN_22 + String (OutputBufferDataBytesNeeded));
+            // DEBUG_V (String ("    ChannelsNeeded: ") + String (ChannelsNeeded));
+            // DEBUG_V (String (" AvailableChannels: ") + String (AvailableChannels));
+            // DEBUG_V (String ("ChannelsToAllocate: ") + String (ChannelsToAllocate));
+            OutputBufferDataBytesNeeded        = 0;
+            VirtualOutputBufferDataBytesNeeded = 0;
+        }
+
+        // DEBUG_V (String ("    ChannelsNeeded: ") + String (OutputBufferDataBytesNeeded));
+        // DEBUG_V (String (" AvailableChannels: ") + String (AvailableChannels));
+
+        OutputBufferOffset += OutputBufferDataBytesNeeded;
+        CurrentOutput.OutputBufferDataSize  = OutputBufferDataBytesNeeded;
+        CurrentOutput.OutputBufferEndOffset = OutputBufferOffset - 1;
+
+        OutputChannelOffset += VirtualOutputBufferDataBytesNeeded;
+        CurrentOutput.OutputChannelSize      = VirtualOutputBufferDataBytesNeeded;
+        CurrentOutput.OutputChannelEndOffset = OutputChannelOffset;
+
+        // can WriteChannelData copy the data directly into the output buffer?
+        CurrentOutput.IdentityMapped = (OutputBufferDataBytesNeeded == VirtualOutputBufferDataBytesNeeded) &&
+                                       ((c_OutputCommon*)CurrentOutput.OutputDriver)->IsIdentityMapped ();
+        // DEBUG_V (String ("    IdentityMapped: ") + String (CurrentOutput.IdentityMapped));
+
+        // DEBUG_V (String("OutputChannel.GetBufferUsedSize: ") + String(OutputChannel.pOutputChannelDriver->GetBufferUsedSize()));
+        // DEBUG_V (String ("OutputBufferOffset: ") + String(OutputBufferOffset));
+    }
+
+    // decide where each output physically lives
+    for (bool PlaceRelays : {false, true})
+    {
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            if (PlaceRelays != (OM_PortType_t::Relay == CurrentOutput.PortType))
+            {
+                continue;
+            }
+
+            if ((InternalBufferOffset + CurrentOutput.OutputBufferDataSize) <= sizeof(OutputBuffer))
+            {
+                CurrentOutput.PhysicalBufferOffset = InternalBufferOffset;
+                InternalBufferOffset += CurrentOutput.OutputBufferDataSize;
+            }
+            else
+            {
+                CurrentOutput.InOverflowBuffer     = true;
+                CurrentOutput.PhysicalBufferOffset = OverflowBufferOffset;
+                OverflowBufferOffset += CurrentOutput.OutputBufferDataSize;
+                OverflowNeedsInternalRam |= !PlaceRelays;
+            }
+        }
+    }
+
+    // DEBUG_V (String ("  InternalBufferSize: ") + String (InternalBufferOffset));
+    // DEBUG_V (String ("  OverflowBufferSize: ") + String (OverflowBufferOffset));
+    if (!UpdateOverflowBuffer (OverflowBufferOffset, OverflowNeedsInternalRam))
+    {
+        logcon (MN_22 + String (OverflowBufferOffset));
+
+        // the outputs in the overflow buffer get nothing
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            if (CurrentOutput.InOverflowBuffer)
+            {
+                CurrentOutput.InOverflowBuffer      = false;
+                CurrentOutput.PhysicalBufferOffset  = 0;
+                CurrentOutput.OutputBufferDataSize  = 0;
+                CurrentOutput.IdentityMapped        = false;
+            }
+        }
+    }
+
+    // DEBUG_V (String ("   TotalBufferSize: ") + String (OutputBufferOffset));
+    UsedBufferSize = OutputBufferOffset;
+    UsedInternalBufferSize = InternalBufferOffset;
+    UpdateInterpolation ();
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        SetDriverBufferAddresses (CurrentOutput);
+        ((c_OutputCommon*)CurrentOutput.OutputDriver)->SetOutputBufferSize (CurrentOutput.OutputBufferDataSize);
+    }
+
+    // DEBUG_V (String ("       OutputBuffer: 0x") + String (uint32_t (OutputBuffer), HEX));
+    // DEBUG_V (String ("     UsedBufferSize: ") + String (uint32_t (UsedBufferSize)));
+    InputMgr.SetBufferInfo (UsedBufferSize);
+
+    // DEBUG_END;
+
+} // UpdateDisplayBufferReferences
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::SetDriverBufferAddresses (DriverInfo_t & CurrentOutput)
+{
+    // DEBUG_START;
+
+    uint8_t ** pBank = (CurrentOutput.InOverflowBuffer) ? pOverflowBank : pInternalBank;
+    c_OutputCommon * pOutput = (c_OutputCommon*)CurrentOutput.OutputDriver;
+
+    // the bank the driver latched may be about to move
+    pOutput->ReleaseFrontBuffer ();
+
+    pOutput->SetOutputBufferAddress(GetFrontBufferAddress (CurrentOutput));
+    pOutput->SetBackBufferAddress(&pBank[FrameHandoff.GetBackBank ()][CurrentOutput.PhysicalBufferOffset]);
+
+    // interpolated outputs send from the interpolation buffer and do not hold a bank
+    bool LatchesBanks = IsDoubleBuffered () && !CurrentOutput.Interpolated;
+    for (uint32_t Bank = 0; Bank < OM_NUM_FRAME_BANKS; ++Bank)
+    {
+        pOutput->SetFrameBankAddress (Bank, LatchesBanks ? &pBank[Bank][CurrentOutput.PhysicalBufferOffset] : nullptr);
+    }
+
+    // DEBUG_END;
+
+} // SetDriverBufferAddresses
+
+//-----------------------------------------------------------------------------
+uint8_t * c_OutputMgr::GetFrontBufferAddress (DriverInfo_t & CurrentOutput)
+{
+    if (CurrentOutput.Interpolated)
+    {
+        return &pInterpolationOutput[CurrentOutput.PhysicalBufferOffset];
+    }
+
+    uint8_t ** pBank = (CurrentOutput.InOverflowBuffer) ? pOverflowBank : pInternalBank;
+    return &pBank[FrameHandoff.GetFrontBank ()][CurrentOutput.PhysicalBufferOffset];
+
+} // GetFrontBufferAddress
+
+//-----------------------------------------------------------------------------
+static uint8_t * AllocateOverflowBank (uint32_t Size, bool NeedsInternalRam)
+{
+    uint8_t * Response = nullptr;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!NeedsInternalRam)
+    {
+        Response = (uint8_t*)heap_caps_malloc (Size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (nullptr == Response)
+    {
+        Response = (uint8_t*)heap_caps_malloc (Size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+#else
+    Response = (uint8_t*)malloc (Size);
+#endif // !defined(ARDUINO_ARCH_ESP32)
+
+    return Response;
+
+} // AllocateOverflowBank
+
+//-----------------------------------------------------------------------------
+/*
+*   Reallocates the overflow buffer when its size changes and adds or drops
+*   the extra banks to match the double buffer setting. Returns false if the
+*   memory is not available.
+*/
+bool c_OutputMgr::UpdateOverflowBuffer (uint32_t NewSize, bool NeedsInternalRam)
+{
+    // DEBUG_START;
+
+    bool Response = true;
+
+    do // once
+    {
+        if (NewSize != OverflowBufferSize)
+        {
+            FreeOverflowBuffer ();
+            if (0 == NewSize)
+            {
+                break;
+            }
+
+            pOverflowBank[0] = AllocateOverflowBank (NewSize, NeedsInternalRam);
+            if (nullptr == pOverflowBank[0])
+            {
+                Response = false;
+                break;
+            }
+            memset (pOverflowBank[0], 0x00, NewSize);
+            for (uint32_t Bank = 1; Bank < OM_NUM_FRAME_BANKS; ++Bank)
+            {
+                pOverflowBank[Bank] = pOverflowBank[0];
+            }
+            OverflowBufferSize = NewSize;
+        }
+
+        if (0 == OverflowBufferSize)
+        {
+            break;
+        }
+
+        for (uint32_t Bank = 1; Bank < OM_NUM_FRAME_BANKS; ++Bank)
+        {
+            if (DoubleBufferEnabled && (pOverflowBank[Bank] == pOverflowBank[0]))
+            {
+                pOverflowBank[Bank] = AllocateOverflowBank (OverflowBufferSize, NeedsInternalRam);
+                if (nullptr == pOverflowBank[Bank])
+                {
+                    pOverflowBank[Bank] = pOverflowBank[0];
+                    FreeOverflowBuffer ();
+                    Response = false;
+                    break;
+                }
+                memcpy (pOverflowBank[Bank], pOverflowBank[0], OverflowBufferSize);
+            }
+            else if (!DoubleBufferEnabled && (pOverflowBank[Bank] != pOverflowBank[0]))
+            {
+                free (pOverflowBank[Bank]);
+                pOverflowBank[Bank] = pOverflowBank[0];
+            }
+        }
+
+    } while (false);
+
+    // DEBUG_V (String ("OverflowBufferSize: ") + String (OverflowBufferSize));
+
+    // DEBUG_END;
+    return Response;
+
+} // UpdateOverflowBuffer
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::FreeOverflowBuffer ()
+{
+    // DEBUG_START;
+
+    for (uint32_t Bank = 1; Bank < OM_NUM_FRAME_BANKS; ++Bank)
+    {
+        if (pOverflowBank[Bank] != pOverflowBank[0])
+        {
+            free (pOverflowBank[Bank]);
+        }
+        pOverflowBank[Bank] = nullptr;
+    }
+    free (pOverflowBank[0]);
+    pOverflowBank[0] = nullptr;
+    OverflowBufferSize = 0;
+
+    // DEBUG_END;
+
+} // FreeOverflowBuffer
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::UpdateDoubleBuffer ()
+{
+    // DEBUG_START;
+
+    if (DoubleBufferEnabled && !IsDoubleBuffered ())
+    {
+        for (uint32_t Bank = 1; Bank < OM_NUM_FRAME_BANKS; ++Bank)
+        {
+            pInternalBank[Bank] = (uint8_t*)malloc (sizeof (OutputBuffer));
+            if (nullptr == pInternalBank[Bank])
+            {
+                logcon (F ("ERROR: Could not allocate the frame buffers. Double buffering is disabled."));
+                DoubleBufferEnabled = false;
+                break;
+            }
+            memcpy (pInternalBank[Bank], OutputBuffer, sizeof (OutputBuffer));
+        }
+    }
+
+    if (!DoubleBufferEnabled)
+    {
+        // keep whatever is currently being displayed
+        uint32_t FrontBank = FrameHandoff.GetFrontBank ();
+        if (IsDoubleBuffered () && (0 != FrontBank))
+        {
+            memcpy (OutputBuffer, pInternalBank[FrontBank], sizeof (OutputBuffer));
+            if (OverflowBufferSize)
+            {
+                memcpy (pOverflowBank[0], pOverflowBank[FrontBank], OverflowBufferSize);
+            }
+        }
+
+        for (uint32_t Bank = 1; Bank < OM_NUM_FRAME_BANKS; ++Bank)
+        {
+            if (OutputBuffer != pInternalBank[Bank])
+            {
+                free (pInternalBank[Bank]);
+            }
+            pInternalBank[Bank] = OutputBuffer;
+        }
+    }
+
+    ResetFrameHandoff ();
+
+    // DEBUG_V (String ("DoubleBufferEnabled: ") + String (DoubleBufferEnabled));
+
+    // DEBUG_END;
+
+} // UpdateDoubleBuffer
+
+//-----------------------------------------------------------------------------
+/*
+*   Only called while the outputs are stopped for a configuration change.
+*/
+void c_OutputMgr::ResetFrameHandoff ()
+{
+    // DEBUG_START;
+
+    // the bank counts start over so no driver may hold on to a bank
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        ((c_OutputCommon*)CurrentOutput.OutputDriver)->ReleaseFrontBuffer ();
+    }
+
+    FrameHandoff.Reset (IsDoubleBuffered ());
+
+    // DEBUG_END;
+
+} // ResetFrameHandoff
+
+//-----------------------------------------------------------------------------
+/*
+*   Runs in the context of the input that is writing the frame. The new back
+*   bank is never one a driver is sending from. E1.31, DDP and Art-Net commit
+*   from the network task while everything else commits from the main loop,
+*   so on the ESP32 a publish holds a lock. The ESP8266 runs both in the
+*   same context.
+*/
+void c_OutputMgr::PublishFrame ()
+{
+    // DEBUG_START;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    xSemaphoreTakeRecursive (PublishFrameLock, portMAX_DELAY);
+#endif // defined(ARDUINO_ARCH_ESP32)
+
+    // anything the drivers keep per bank has to be in place before the outputs can take the frame
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        ((c_OutputCommon*)CurrentOutput.OutputDriver)->FrameCommitted(FrameHandoff.GetBackBank ());
+    }
+
+    uint32_t PublishedBank = FrameHandoff.Publish ();
+    uint32_t BackBank      = FrameHandoff.GetBackBank ();
+
+    // inputs that only update part of the buffer build on the frame just published
+    memcpy (pInternalBank[BackBank], pInternalBank[PublishedBank], UsedInternalBufferSize);
+    if (OverflowBufferSize)
+    {
+        memcpy (pOverflowBank[BackBank], pOverflowBank[PublishedBank], OverflowBufferSize);
+    }
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        uint8_t ** pBank = (CurrentOutput.InOverflowBuffer) ? pOverflowBank : pInternalBank;
+        ((c_OutputCommon*)CurrentOutput.OutputDriver)->SetBackBufferAddress(&pBank[BackBank][CurrentOutput.PhysicalBufferOffset]);
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    xSemaphoreGiveRecursive (PublishFrameLock);
+#endif // defined(ARDUINO_ARCH_ESP32)
+
+    // DEBUG_END;
+
+} // PublishFrame
+
+//-----------------------------------------------------------------------------
+/*
+*   Called from Poll before the drivers are polled. The drivers latch the
+*   front bank when they start a frame so a frame that is in progress
+*   finishes with the data it started with. A new frame waits until every
+*   driver is done with the bank it replaces.
+*/
+bool c_OutputMgr::TakeFrame ()
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    if (FrameHandoff.Take ())
+    {
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            ((c_OutputCommon*)CurrentOutput.OutputDriver)->SetFrontBufferAddress(GetFrontBufferAddress (CurrentOutput));
+            ((c_OutputCommon*)CurrentOutput.OutputDriver)->KickFrame();
+        }
+
+        if (nullptr != pInterpolationOutput)
+        {
+            StartInterpolation ();
+        }
+        Response = true;
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // TakeFrame
+
+//-----------------------------------------------------------------------------
+/*
+*   Interpolation needs the frame handoff. The outputs hold on to the latest
+*   frame until the next one arrives, which gives a stable target to blend to.
+*   Only outputs in the internal buffer whose bytes are all 8 bit intensities
+*   are blended. Called while the outputs are stopped for a configuration change.
+*/
+void c_OutputMgr::UpdateInterpolation ()
+{
+    // DEBUG_START;
+
+    free (pInterpolationFrom);
+    free (pInterpolationOutput);
+    pInterpolationFrom   = nullptr;
+    pInterpolationOutput = nullptr;
+    InterpolationStep    = OM_INTERPOLATION_STEPS;
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        CurrentOutput.Interpolated = false;
+    }
+
+    do // once
+    {
+        if (!InterpolationEnabled || (0 == UsedInternalBufferSize))
+        {
+            break;
+        }
+
+        if (!IsDoubleBuffered ())
+        {
+            logcon (F ("Interpolation needs double buffering. Interpolation is disabled."));
+            break;
+        }
+
+        pInterpolationFrom   = (uint8_t*)malloc (UsedInternalBufferSize);
+        pInterpolationOutput = (uint8_t*)malloc (UsedInternalBufferSize);
+        if ((nullptr == pInterpolationFrom) || (nullptr == pInterpolationOutput))
+        {
+            logcon (F ("ERROR: Could not allocate the interpolation buffers. Interpolation is disabled."));
+            free (pInterpolationFrom);
+            free (pInterpolationOutput);
+            pInterpolationFrom   = nullptr;
+            pInterpolationOutput = nullptr;
+            break;
+        }
+        memcpy (pInterpolationFrom,   pInternalBank[FrameHandoff.GetFrontBank ()], UsedInternalBufferSize);
+        memcpy (pInterpolationOutput, pInternalBank[FrameHandoff.GetFrontBank ()], UsedInternalBufferSize);
+
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            CurrentOutput.Interpolated = !CurrentOutput.InOverflowBuffer &&
+                                         (0 != CurrentOutput.OutputBufferDataSize) &&
+                                         ((c_OutputCommon*)CurrentOutput.OutputDriver)->CanInterpolate ();
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+
+} // UpdateInterpolation
+
+//-----------------------------------------------------------------------------
+/*
+*   A new frame has arrived. Blend to it from whatever is being sent right
+*   now over the time the previous frame took to arrive.
+*/
+void c_OutputMgr::StartInterpolation ()
+{
+    // DEBUG_START;
+
+    uint32_t Now = micros ();
+
+    memcpy (pInterpolationFrom, pInterpolationOutput, UsedInternalBufferSize);
+
+    InterpolationDurationUs = min (Now - LastFrameTakenUs, uint32_t (OM_INTERPOLATION_MAX_MS * 1000));
+    InterpolationStartUs    = Now;
+    LastFrameTakenUs        = Now;
+    InterpolationStep       = 0;
+
+    // a new blend for every output refresh
+    InterpolationPeriodUs = FrameTickPeriodMicroSec;
+    if (0 == InterpolationPeriodUs)
+    {
+        InterpolationPeriodUs = OM_INTERPOLATION_MAX_MS * 1000;
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            if (CurrentOutput.Interpolated)
+            {
+                InterpolationPeriodUs = min (InterpolationPeriodUs, ((c_OutputCommon*)CurrentOutput.OutputDriver)->GetFrameTimeMs () * 1000);
+            }
+        }
+    }
+    InterpolationLastUs = Now - InterpolationPeriodUs;
+
+    // DEBUG_END;
+
+} // StartInterpolation
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::Interpolate ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (OM_INTERPOLATION_STEPS == InterpolationStep)
+        {
+            // the outputs have caught up with the latest frame
+            break;
+        }
+
+        uint32_t Now = micros ();
+        if ((Now - InterpolationLastUs) < InterpolationPeriodUs)
+        {
+            break;
+        }
+        InterpolationLastUs = Now;
+
+        uint32_t Elapsed = Now - InterpolationStartUs;
+        uint32_t Step = (Elapsed >= InterpolationDurationUs) ? OM_INTERPOLATION_STEPS :
+                        ((Elapsed * OM_INTERPOLATION_STEPS) / InterpolationDurationUs);
+        if (Step == InterpolationStep)
+        {
+            break;
+        }
+        InterpolationStep = Step;
+
+        uint8_t * pTo = pInternalBank[FrameHandoff.GetFrontBank ()];
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            if (!CurrentOutput.Interpolated)
+            {
+                continue;
+            }
+
+            uint32_t EndOffset = CurrentOutput.PhysicalBufferOffset + CurrentOutput.OutputBufferDataSize;
+            for (uint32_t Offset = CurrentOutput.PhysicalBufferOffset; Offset < EndOffset; ++Offset)
+            {
+                int32_t From = pInterpolationFrom[Offset];
+                pInterpolationOutput[Offset] = uint8_t (From + (((int32_t (pTo[Offset]) - From) * int32_t (Step)) >> 8));
+            }
+            ((c_OutputCommon*)CurrentOutput.OutputDriver)->MarkDirty ();
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+
+} // Interpolate
+
+//-----------------------------------------------------------------------------
+uint32_t c_OutputMgr::ReadOutputBuffer (uint32_t Offset, uint32_t Count, uint8_t * pTarget)
+{
+    // DEBUG_START;
+
+    uint32_t BytesCopied = 0;
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        if ((0 == Count) || (0 == CurrentOutput.OutputBufferDataSize))
+        {
+            continue;
+        }
+
+        uint32_t EndOffset = CurrentOutput.OutputBufferStartingOffset + CurrentOutput.OutputBufferDataSize;
+        if ((Offset < CurrentOutput.OutputBufferStartingOffset) || (Offset >= EndOffset))
+        {
+            continue;
+        }
+
+        uint8_t ** pBank = (CurrentOutput.InOverflowBuffer) ? pOverflowBank : pInternalBank;
+        uint32_t BytesToCopy = min (Count, EndOffset - Offset);
+        memcpy (pTarget,
+                &pBank[FrameHandoff.GetFrontBank ()][CurrentOutput.PhysicalBufferOffset + (Offset - CurrentOutput.OutputBufferStartingOffset)],
+                BytesToCopy);
+
+        Offset      += BytesToCopy;
+        Count       -= BytesToCopy;
+        pTarget     += BytesToCopy;
+        BytesCopied += BytesToCopy;
+    }
+
+    // DEBUG_END;
+    return BytesCopied;
+
+} // ReadOutputBuffer
+
+//-----------------------------------------------------------------------------
+uint32_t c_OutputMgr::WriteOutputBuffer (uint32_t Offset, uint32_t Count, uint8_t * pSource)
+{
+    // DEBUG_START;
+
+    uint32_t BytesCopied = 0;
+
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        if ((0 == Count) || (0 == CurrentOutput.OutputBufferDataSize))
+        {
+            continue;
+        }
+
+        uint32_t EndOffset = CurrentOutput.OutputBufferStartingOffset + CurrentOutput.OutputBufferDataSize;
+        if ((Offset < CurrentOutput.OutputBufferStartingOffset) || (Offset >= EndOffset))
+        {
+            continue;
+        }
+
+        uint8_t ** pBank = (CurrentOutput.InOverflowBuffer) ? pOverflowBank : pInternalBank;
+        uint32_t BytesToCopy = min (Count, EndOffset - Offset);
+        memcpy (&pBank[FrameHandoff.GetBackBank ()][CurrentOutput.PhysicalBufferOffset + (Offset - CurrentOutput.OutputBufferStartingOffset)],
+                pSource,
+                BytesToCopy);
+        ((c_OutputCommon*)CurrentOutput.OutputDriver)->MarkDirty ();
+
+        Offset      += BytesToCopy;
+        Count       -= BytesToCopy;
+        pSource     += BytesToCopy;
+        BytesCopied += BytesToCopy;
+    }
+
+    // DEBUG_END;
+    return BytesCopied;
+
+} // WriteOutputBuffer
+
+//-----------------------------------------------------------------------------
+/*
+*   A commit sends the frame on every output at once. With double buffering
+*   the outputs are kicked by TakeFrame once the frame is in the front bank.
+*   When the scheduler is running the kicked outputs still start on the next
+*   tick.
+*/
+void c_OutputMgr::CommitFrame ()
+{
+    // DEBUG_START;
+
+    LastFrameCommitMS = millis ();
+    if (IsDoubleBuffered ())
+    {
+        PublishFrame ();
+    }
+    else
+    {
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            ((c_OutputCommon*)CurrentOutput.OutputDriver)->KickFrame();
+        }
+    }
+
+    // DEBUG_END;
+
+} // CommitFrame
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCount, uint8_t *pSourceData)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if(OutputIsPaused || (CaptureReplaying == CaptureState))
+        {
+            // DEBUG_V("Ignore the write request");
+            break;
+        }
+        if (((StartChannelId + ChannelCount) > UsedBufferSize) || (0 == ChannelCount))
+        {
+            // DEBUG_V (String("ERROR: Invalid parameters"));
+            // DEBUG_V (String("StartChannelId: ") + String(StartChannelId));
+            // DEBUG_V (String("  ChannelCount: ") + String(ChannelCount));
+            // DEBUG_V (String("UsedBufferSize: ") + String(UsedBufferSize));
+            break;
+        }
+
+        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
+        uint32_t EndChannelId = StartChannelId + ChannelCount;
+        // Serial.print('1');
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            // Serial.print('2');
+            // does this output handle this block of data?
+            if (StartChannelId < CurrentOutput.OutputChannelStartingOffset)
+            {
+                // we have gone beyond where we can put this data.
+                // Serial.print('3');
+                break;
+            }
+
+            if (StartChannelId > CurrentOutput.OutputChannelEndOffset)
+            {
+                // move to the next driver
+                // Serial.print('4');
+                continue;
+            }
+            // Serial.print('5');
+
+            uint32_t lastChannelToSet = min(EndChannelId, CurrentOutput.OutputChannelEndOffset);
+            uint32_t ChannelsToSet = lastChannelToSet - StartChannelId;
+            uint32_t RelativeStartChannelId = StartChannelId - CurrentOutput.OutputChannelStartingOffset;
+            // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
+            // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
+            // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
+            // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
+            if (ChannelsToSet)
+            {
+                if (CurrentOutput.IdentityMapped)
+                {
+                    // no per channel processing needed
+                    memcpy(&((c_OutputCommon*)CurrentOutput.OutputDriver)->GetBackBufferAddress()[RelativeStartChannelId], pSourceData, ChannelsToSet);
+                    ((c_OutputCommon*)CurrentOutput.OutputDriver)->MarkDirty();
+                }
+                else
+                {
+                    ((c_OutputCommon*)CurrentOutput.OutputDriver)->WriteChannelData(RelativeStartChannelId, ChannelsToSet, pSourceData);
+                }
+            }
+            StartChannelId += ChannelsToSet;
+            pSourceData += ChannelsToSet;
+            // memcpy(&OutputBuffer[StartChannelId], pSourceData, ChannelCount);
+        }
+
+        // Inputs that do not mark the end of a frame get their data sent as it arrives
+        if (IsDoubleBuffered () && ((millis () - LastFrameCommitMS) > OM_FRAME_COMMIT_TIMEOUT_MS))
+        {
+            PublishFrame ();
+        }
+
+    } while (false);
+    // DEBUG_END;
+
+} // WriteChannelData
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if(OutputIsPaused)
+        {
+            // DEBUG_V("Ignore the read request");
+            break;
+        }
+        if ((StartChannelId + ChannelCount) > UsedBufferSize)
+        {
+            // DEBUG_V (String("ERROR: Invalid parameters"));
+            // DEBUG_V (String("StartChannelId: ") + String(StartChannelId, HEX));
+            // DEBUG_V (String("  ChannelCount: ") + String(ChannelCount));
+            // DEBUG_V (String("UsedBufferSize: ") + String(UsedBufferSize));
+            break;
+        }
+        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
+        uint32_t EndChannelId = StartChannelId + ChannelCount;
+        // Serial.print('1');
+        for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+        {
+            // Serial.print('2');
+            // does this output handle this block of data?
+            if (StartChannelId < CurrentOutput.OutputChannelStartingOffset)
+            {
+                // we have gone beyond where we can put this data.
+                // Serial.print('3');
+                break;
+            }
+
+            if (StartChannelId > CurrentOutput.OutputChannelEndOffset)
+            {
+                // move to the next driver
+                // Serial.print('4');
+                continue;
+            }
+            // Serial.print('5');
+
+            uint32_t lastChannelToSet = min(EndChannelId, CurrentOutput.OutputChannelEndOffset);
+            uint32_t ChannelsToSet = lastChannelToSet - StartChannelId;
+            uint32_t RelativeStartChannelId = StartChannelId - CurrentOutput.OutputChannelStartingOffset;
+            // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
+            // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
+            // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
+            // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
+            ((c_OutputCommon*)CurrentOutput.OutputDriver)->ReadChannelData(RelativeStartChannelId, ChannelsToSet, pTargetData);
+            StartChannelId += ChannelsToSet;
+            pTargetData += ChannelsToSet;
+            // memcpy(&OutputBuffer[StartChannelId], pTargetData, ChannelCount);
+        }
+
+    } while (false);
+    // DEBUG_END;
+
+} // ReadChannelData
+
+//-----------------------------------------------------------------------------
+/*
+*   Only the back bank is cleared. The other banks may be latched by a driver
+*   that is still sending from them. The cleared frame goes out like any other.
+*/
+void c_OutputMgr::ClearBuffer()
+{
+    // DEBUG_START;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // keep the back bank from moving until the cleared frame is published
+    xSemaphoreTakeRecursive (PublishFrameLock, portMAX_DELAY);
+#endif // defined(ARDUINO_ARCH_ESP32)
+
+    uint32_t BackBank = FrameHandoff.GetBackBank ();
+    memset(pInternalBank[BackBank], 0x00, OutputMgr.GetBufferSize());
+    if (nullptr != pOverflowBank[BackBank])
+    {
+        memset(pOverflowBank[BackBank], 0x00, OverflowBufferSize);
+    }
+
+    // let each driver set its own idea of an all off value
+    for (DriverInfo_t & CurrentOutput : OutputChannelDrivers)
+    {
+        ((c_OutputCommon*)CurrentOutput.OutputDriver)->ClearBuffer();
+    }
+
+    // the drivers cleared the back buffer. Send it.
+    if (IsDoubleBuffered ())
+    {
+        PublishFrame ();
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    xSemaphoreGiveRecursive (PublishFrameLock);
+#endif // defined(ARDUINO_ARCH_ESP32)
+
+    // DEBUG_END;
+
+} // ClearBuffer
@@ -32,6 +32,7 @@ c_OutputPixel::c_OutputPixel (c_OutputMgr::e_OutputChannelIds OutputChannelId,
 
     updateGammaTable ();
     updateColorOrderOffsets ();
+    updatePixelRemapTable ();
 
     FrameStateFuncPtr = &c_OutputPixel::FrameDone;
 
@@ -45,6 +46,35 @@ c_OutputPixel::~c_OutputPixel ()
 {
     // DEBUG_START;
 
+    if (nullptr != pPixelRemapTable)
+    {
+        free (pPixelRemapTable);
+        pPixelRemapTable = nullptr;
+    }
+
+    NumSegments = 0;
+    updateSegmentMap ();
+    if (nullptr != pSegments)
+    {
+        free (pSegments);
+        pSegments = nullptr;
+    }
+
+    if (nullptr != pColorCorrection)
+    {
+        free (pColorCorrection);
+        pColorCorrection = nullptr;
+    }
+
+    Dither = false;
+    updateDitherTables ();
+
+    if (nullptr != pGammaTable16)
+    {
+        free (pGammaTable16);
+        pGammaTable16 = nullptr;
+    }
+
     // DEBUG_END;
 } // ~c_OutputPixel
 
@@ -67,6 +97,12 @@ void c_OutputPixel::GetConfig (ArduinoJson::JsonObject& jsonConfig)
     JsonWrite(jsonConfig, CN_interframetime,   InterFrameGapInMicroSec);
     JsonWrite(jsonConfig, CN_prependnullcount, PrependNullPixelCount);
     JsonWrite(jsonConfig, CN_appendnullcount,  AppendNullPixelCount);
+    JsonWrite(jsonConfig, CN_dither,           Dither);
+    JsonWrite(jsonConfig, CN_input_16bit,      Input16Bit);
+    JsonWrite(jsonConfig, CN_power_limit,      PowerLimitMa);
+    JsonWrite(jsonConfig, CN_channel_current,  serialized(String(ChannelCurrentMa, 1)));
+    GetSegmentConfig (jsonConfig);
+    GetColorCorrectionConfig (jsonConfig);
 
     c_OutputCommon::GetConfig (jsonConfig);
 
@@ -81,6 +117,12 @@ void c_OutputPixel::GetStatus (ArduinoJson::JsonObject& jsonStatus)
 
     c_OutputCommon::BaseGetStatus (jsonStatus);
 
+    if (PowerLimitMa)
+    {
+        JsonWrite(jsonStatus, F("EstimatedCurrentMa"), EstimatedCurrentMa);
+        JsonWrite(jsonStatus, F("PowerScale"),         (PowerScale * 100) / PIXEL_POWER_SCALE_NONE);
+    }
+
 #ifdef USE_PIXEL_DEBUG_COUNTERS
     JsonObject debugStatus = jsonStatus["Pixel Debug"].to<JsonObject>();
     debugStatus["NumIntensityBytesPerPixel"]        = NumIntensityBytesPerPixel;
@@ -133,6 +175,8 @@ void c_OutputPixel::SetOutputBufferSize(uint32_t NumChannelsAvailable)
         // Stop current output operation
         c_OutputCommon::SetOutputBufferSize (NumChannelsAvailable);
         SetFrameDurration (IntensityBitTimeInUs, BlockSize, BlockDelayUs);
+        updateDitherTables ();
+        updateIntensitySum ();
 
     } while (false);
 
@@ -192,6 +236,12 @@ bool c_OutputPixel::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     setFromJSON (InterFrameGapInMicroSec, jsonConfig, CN_interframetime);
     setFromJSON (PrependNullPixelCount, jsonConfig, CN_prependnullcount);
     setFromJSON (AppendNullPixelCount, jsonConfig, CN_appendnullcount);
+    setFromJSON (Dither, jsonConfig, CN_dither);
+    setFromJSON (Input16Bit, jsonConfig, CN_input_16bit);
+    setFromJSON (PowerLimitMa, jsonConfig, CN_power_limit);
+    setFromJSON (ChannelCurrentMa, jsonConfig, CN_channel_current);
+    SetSegmentConfig (jsonConfig);
+    SetColorCorrectionConfig (jsonConfig);
 
     c_OutputCommon::SetConfig (jsonConfig);
 
@@ -207,8 +257,11 @@ bool c_OutputPixel::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     // DEBUG_V (String ("brightness: ") + String (brightness));
     // DEBUG_V (String ("AdjustedBrightness: ") + String (AdjustedBrightness));
 
+    updateIntensityWidth ();
     updateGammaTable ();
+    updateDitherTables ();
     updateColorOrderOffsets ();
+    updateColorCorrection ();
 
     // Update the config fields in case the validator changed them
     GetConfig (jsonConfig);
@@ -216,8 +269,13 @@ bool c_OutputPixel::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     PixelGroupSize = (2 > PixelGroupSize) ? 1 : PixelGroupSize;
     // DEBUG_V (String ("PixelGroupSize: ") + String (PixelGroupSize));
 
+    updatePixelRemapTable ();
+
     SetFrameDurration(IntensityBitTimeInUs, BlockSize, BlockDelayUs);
 
+    CurrentPerIntensityQ16 = uint32_t ((max (ChannelCurrentMa, float (0.0)) * 65536.0) / 255.0);
+    updateIntensitySum ();
+
     // DEBUG_V (String ("     zig_size: ") + String (zig_size));
 
     // DEBUG_END;
@@ -232,288 +290,880 @@ void c_OutputPixel::updateGammaTable ()
     double tempBrightness = double (brightness) / 100.0;
     // DEBUG_V (String ("tempBrightness: ") + String (tempBrightness));
 
-    for (unsigned int i = 0; i < sizeof (gamma_table); ++i)
+    // Inverted outputs store their intensity data pre inverted so that
+    // the ISR can send the buffer content without touching it.
+    InvertMask = (InvertData) ? uint32_t(-1) : 0;
+
+    FillGammaTable (gamma_table, gamma);
+
+    for (uint32_t SegmentId = 0; SegmentId < NumSegments; ++SegmentId)
     {
-        // ESP.wdtFeed ();
-        gamma_table[i] = (uint8_t)min ((255.0 * pow (i * tempBrightness / 255, gamma) + 0.5), 255.0);
-        // DEBUG_V (String ("i: ") + String (i));
-        // DEBUG_V (String ("gamma_table[i]: ") + String (gamma_table[i]));
+        FillGammaTable (pSegments[SegmentId].GammaTable, pSegments[SegmentId].Gamma);
+    }
+
+    // 16 bit outputs interpolate between the entries of a table indexed by the upper 8 bits
+    if (nullptr != pGammaTable16)
+    {
+        for (unsigned int i = 0; i <= sizeof (gamma_table); ++i)
+        {
+            double GammaValue = 65535.0 * pow (i * tempBrightness / 256, gamma) * double (AdjustedBrightness) / 256.0;
+            pGammaTable16[i] = uint16_t (min (GammaValue + 0.5, 65535.0));
+        }
     }
 
     // DEBUG_END;
 } // updateGammaTable
 
 //----------------------------------------------------------------------------
-void c_OutputPixel::updateColorOrderOffsets ()
+void c_OutputPixel::FillGammaTable (uint8_t * pTable, float Gamma)
 {
     // DEBUG_START;
-    // make sure the color order is all lower case
-    String _color_order = String(color_order);
-    _color_order.toLowerCase ();
+    double tempBrightness = double (brightness) / 100.0;
 
-    // DEBUG_V (String (" color_order: ") + color_order);
-    // DEBUG_V (String ("_color_order: ") + _color_order);
-
-         if (String (F ("rgb"))  == _color_order) { ColorOffsets.offset.r = 0; ColorOffsets.offset.g = 1; ColorOffsets.offset.b = 2; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 3; }
-    else if (String (F ("rbg"))  == _color_order) { ColorOffsets.offset.r = 0; ColorOffsets.offset.g = 2; ColorOffsets.offset.b = 1; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 3; }
-    else if (String (F ("gbr"))  == _color_order) { ColorOffsets.offset.r = 2; ColorOffsets.offset.g = 0; ColorOffsets.offset.b = 1; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 3; }
-    else if (String (F ("grb"))  == _color_order) { ColorOffsets.offset.r = 1; ColorOffsets.offset.g = 0; ColorOffsets.offset.b = 2; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 3; }
-    else if (String (F ("brg"))  == _color_order) { ColorOffsets.offset.r = 1; ColorOffsets.offset.g = 2; ColorOffsets.offset.b = 0; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 3; }
-    else if (String (F ("bgr"))  == _color_order) { ColorOffsets.offset.r = 2; ColorOffsets.offset.g = 1; ColorOffsets.offset.b = 0; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 3; }
-    else if (String (F ("wrgb")) == _color_order) { ColorOffsets.offset.r = 1; ColorOffsets.offset.g = 2; ColorOffsets.offset.b = 3; ColorOffsets.offset.w = 0; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("wrbg")) == _color_order) { ColorOffsets.offset.r = 1; ColorOffsets.offset.g = 3; ColorOffsets.offset.b = 2; ColorOffsets.offset.w = 0; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("wgbr")) == _color_order) { ColorOffsets.offset.r = 3; ColorOffsets.offset.g = 1; ColorOffsets.offset.b = 2; ColorOffsets.offset.w = 0; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("wgrb")) == _color_order) { ColorOffsets.offset.r = 2; ColorOffsets.offset.g = 1; ColorOffsets.offset.b = 3; ColorOffsets.offset.w = 0; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("wbrg")) == _color_order) { ColorOffsets.offset.r = 2; ColorOffsets.offset.g = 3; ColorOffsets.offset.b = 1; ColorOffsets.offset.w = 0; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("wbgr")) == _color_order) { ColorOffsets.offset.r = 3; ColorOffsets.offset.g = 2; ColorOffsets.offset.b = 1; ColorOffsets.offset.w = 0; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("rgbw")) == _color_order) { ColorOffsets.offset.r = 0; ColorOffsets.offset.g = 1; ColorOffsets.offset.b = 2; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("rbgw")) == _color_order) { ColorOffsets.offset.r = 0; ColorOffsets.offset.g = 2; ColorOffsets.offset.b = 1; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("gbrw")) == _color_order) { ColorOffsets.offset.r = 2; ColorOffsets.offset.g = 0; ColorOffsets.offset.b = 1; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("grbw")) == _color_order) { ColorOffsets.offset.r = 1; ColorOffsets.offset.g = 0; ColorOffsets.offset.b = 2; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("brgw")) == _color_order) { ColorOffsets.offset.r = 1; ColorOffsets.offset.g = 2; ColorOffsets.offset.b = 0; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 4; }
-    else if (String (F ("bgrw")) == _color_order) { ColorOffsets.offset.r = 2; ColorOffsets.offset.g = 1; ColorOffsets.offset.b = 0; ColorOffsets.offset.w = 3; NumIntensityBytesPerPixel = 4; }
-    else
+    for (unsigned int i = 0; i < sizeof (gamma_table); ++i)
     {
-        // DEBUG_V(String(F("Error: Unsupported Color Order: '")) + _color_order + F("'. Using RGB"));
-        strcpy(color_order, String(F ("rgb")).c_str());
-        ColorOffsets.offset.r = 0;
-        ColorOffsets.offset.g = 1;
-        ColorOffsets.offset.b = 2;
-        ColorOffsets.offset.w = 3;
-        NumIntensityBytesPerPixel = 3;
-    } // default
-
-    // DEBUG_V (String ("NumIntensityBytesPerPixel: ") + String (NumIntensityBytesPerPixel));
+        // ESP.wdtFeed ();
+        uint32_t GammaValue = (uint8_t)min ((255.0 * pow (i * tempBrightness / 255, Gamma) + 0.5), 255.0);
+        pTable[i] = uint8_t(((GammaValue * AdjustedBrightness) >> 8) ^ InvertMask);
+        // DEBUG_V (String ("i: ") + String (i));
+        // DEBUG_V (String ("pTable[i]: ") + String (pTable[i]));
+    }
 
     // DEBUG_END;
-} // updateColorOrderOffsets
+} // FillGammaTable
 
 //----------------------------------------------------------------------------
-bool c_OutputPixel::validate ()
+/*
+*   Outputs with more than 8 bits per intensity keep 16 bits per intensity in
+*   the output buffer (high byte first) so the ISR only has to read it.
+*/
+void c_OutputPixel::updateIntensityWidth ()
 {
     // DEBUG_START;
-    bool response = true;
 
-    if (zig_size > pixel_count)
-    {
-        logcon (CN_stars + String (F (" Requested ZigZag size count was too high. Setting to ")) + pixel_count + " " + CN_stars);
-        zig_size = pixel_count;
-        response = false;
-    }
-    else if (2 > zig_size)
+    if ((1 == BytesPerIntensity) && (nullptr != pGammaTable16))
     {
-        zig_size = 1;
+        free (pGammaTable16);
+        pGammaTable16 = nullptr;
     }
 
-    // Default gamma value
-    if (gamma <= 0)
+    if ((2 == BytesPerIntensity) && (nullptr == pGammaTable16))
     {
-        gamma = 2.2;
-        response = false;
+        pGammaTable16 = (uint16_t*)malloc ((sizeof (gamma_table) + 1) * sizeof (uint16_t));
+        if (nullptr == pGammaTable16)
+        {
+            logcon (CN_stars + String (F (" Could not allocate the 16 bit gamma table. Using 8 bit intensities ")) + CN_stars);
+            BytesPerIntensity = 1;
+        }
     }
 
-    // Max brightness value
-    if (brightness > 100)
-    {
-        brightness = 100;
-        // DEBUG_V (String ("brightness: ") + String (brightness));
-        response = false;
-    }
+    InputBytesPerIntensity = ((2 == BytesPerIntensity) && Input16Bit) ? 2 : 1;
+    PartialIntensityChannelId = uint32_t (-1);
 
-    // DEBUG_END;
-    return response;
+    // DEBUG_V (String ("     BytesPerIntensity: ") + String (BytesPerIntensity));
+    // DEBUG_V (String ("InputBytesPerIntensity: ") + String (InputBytesPerIntensity));
 
-} // validate
+    // DEBUG_END;
+} // updateIntensityWidth
 
 //----------------------------------------------------------------------------
-void c_OutputPixel::SetFrameDurration (float _IntensityBitTimeInUs, uint16_t BlockSize, float BlockDelayUs)
+/*
+*   Temporal dithering keeps the fraction that the gamma / brightness table
+*   drops and carries it into the next frame for each channel. Over several
+*   frames the pixel shows the average of the higher precision intensity.
+*/
+void c_OutputPixel::updateDitherTables ()
 {
     // DEBUG_START;
-    if (0 == BlockSize) { BlockSize = 1; }
-
-    IntensityBitTimeInUs = _IntensityBitTimeInUs;
-
-    float TotalIntensityBytes       = OutputBufferSize;
-    float TotalNullBytes            = (PrependNullPixelCount + AppendNullPixelCount) * NumIntensityBytesPerPixel;
-    float TotalBytesOfIntensityData = (TotalIntensityBytes + TotalNullBytes + FramePrependDataSize);
-    float TotalBits                 = TotalBytesOfIntensityData * 8.0;
-    uint16_t NumBlocks              = uint16_t (TotalBytesOfIntensityData / float (BlockSize));
-    int TotalBlockDelayUs           = int (float (NumBlocks) * BlockDelayUs);
-
-    ActualFrameDurationMicroSec = (IntensityBitTimeInUs * TotalBits) + InterFrameGapInMicroSec + TotalBlockDelayUs;
-    FrameDurationInMicroSec = max(uint32_t(25000), ActualFrameDurationMicroSec);
-    
-    // DEBUG_V (String ("           OutputBufferSize: ") + String (OutputBufferSize));
-    // DEBUG_V (String ("             PixelGroupSize: ") + String (PixelGroupSize));
-    // DEBUG_V (String ("        TotalIntensityBytes: ") + String (TotalIntensityBytes));
-    // DEBUG_V (String ("      PrependNullPixelCount: ") + String (PrependNullPixelCount));
-    // DEBUG_V (String ("       AppendNullPixelCount: ") + String (AppendNullPixelCount));
-    // DEBUG_V (String ("  NumIntensityBytesPerPixel: ") + String (NumIntensityBytesPerPixel));
-    // DEBUG_V (String ("             TotalNullBytes: ") + String (TotalNullBytes));
-    // DEBUG_V (String ("       FramePrependDataSize: ") + String (FramePrependDataSize));
-    // DEBUG_V (String ("  TotalBytesOfIntensityData: ") + String (TotalBytesOfIntensityData));
-    // DEBUG_V (String ("                  TotalBits: ") + String (TotalBits));
-    // DEBUG_V (String ("                  BlockSize: ") + String (BlockSize));
-    // DEBUG_V (String ("                  NumBlocks: ") + String (NumBlocks));
-    // DEBUG_V (String ("               BlockDelayUs: ") + String (BlockDelayUs));
-    // DEBUG_V (String ("          TotalBlockDelayUs: ") + String (TotalBlockDelayUs));
-    // DEBUG_V (String ("       IntensityBitTimeInUs: ") + String (IntensityBitTimeInUs));
-    // DEBUG_V (String ("    InterFrameGapInMicroSec: ") + String (InterFrameGapInMicroSec));
-    // DEBUG_V (String ("ActualFrameDurationMicroSec: ") + String (ActualFrameDurationMicroSec));
-    // DEBUG_V (String (" FrameDurationInMicroSec: ") + String (FrameDurationInMicroSec));
-
-    // DEBUG_END;
 
-} // SetInterframeGap
+    if (nullptr != pDitherTable)
+    {
+        free (pDitherTable);
+        pDitherTable = nullptr;
+    }
 
-//----------------------------------------------------------------------------
-void IRAM_ATTR c_OutputPixel::SetStartingSendPixelState()
-{
-    if(PixelPrependDataSize)
+    if (nullptr != pDitherResidue)
     {
-        FrameStateFuncPtr = &c_OutputPixel::PixelSendPrependIntensity;
+        free (pDitherResidue);
+        pDitherResidue = nullptr;
     }
-    else
+
+    do // once
     {
-#ifdef SUPPORT_OutputType_GECE
-        if (OutputType == OTYPE_t::OutputType_GECE)
+        if (!Dither || (0 == OutputBufferSize) || (1 != BytesPerIntensity))
         {
-            FrameStateFuncPtr = &c_OutputPixel::PixelSendGECEIntensity;
+            // DEBUG_V ("No dithering");
+            break;
         }
-        else
+
+        pDitherTable   = (uint16_t*)malloc (sizeof (gamma_table) * sizeof (uint16_t));
+        pDitherResidue = (uint8_t*)malloc (OutputBufferSize);
+        if ((nullptr == pDitherTable) || (nullptr == pDitherResidue))
         {
-            FrameStateFuncPtr = &c_OutputPixel::PixelSendIntensity;
+            logcon (CN_stars + String (F (" Could not allocate the dithering tables. Dithering is disabled ")) + CN_stars);
+            free (pDitherTable);
+            pDitherTable = nullptr;
+            free (pDitherResidue);
+            pDitherResidue = nullptr;
+            break;
         }
-#else
-        FrameStateFuncPtr = &c_OutputPixel::PixelSendIntensity;
-#endif // def SUPPORT_OutputType_GECE
-    }
+        memset (pDitherResidue, 0x00, OutputBufferSize);
 
-} // SetStartingSendPixelState
+        double tempBrightness = double (brightness) / 100.0;
+        for (unsigned int i = 0; i < sizeof (gamma_table); ++i)
+        {
+            double GammaValue = min ((255.0 * pow (i * tempBrightness / 255, gamma)), 255.0);
+            pDitherTable[i] = uint16_t (GammaValue * double (AdjustedBrightness));
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+} // updateDitherTables
 
 //----------------------------------------------------------------------------
-void c_OutputPixel::StartNewFrame ()
+void c_OutputPixel::updateColorOrderOffsets ()
 {
     // DEBUG_START;
 
-#ifdef USE_PIXEL_DEBUG_COUNTERS
-    if (ISR_MoreDataToSend ())
-    {
-        AbortFrameCounter++;
-    }
-    FrameStartCounter++;
-#endif // def USE_PIXEL_DEBUG_COUNTERS
-
-    NextPixelToSend = GetBufferAddress();
-    FramePrependDataCurrentIndex    = 0;
-    FrameAppendDataCurrentIndex     = 0;
-    SentPixelsCount                 = 0;
-    PixelIntensityCurrentIndex      = 0;
-    PixelIntensityCurrentColor      = 0;
-    PrependNullPixelCurrentCount    = 0;
-    AppendNullPixelCurrentCount     = 0;
-    PixelPrependDataCurrentIndex    = 0;
-    GECEPixelId                     = 0;
+    // DEBUG_V (String (" color_order: ") + color_order);
 
-    if(FramePrependDataSize)
-    {
-        FrameStateFuncPtr = &c_OutputPixel::FramePrependData;
-    }
-    else if (PrependNullPixelCount)
-    {
-        FrameStateFuncPtr = &c_OutputPixel::PixelPrependNulls;
-    }
-    else
+    if (!GetColorOrderOffsets (String (color_order), ColorOffsets, NumIntensityBytesPerPixel))
     {
-        SetStartingSendPixelState ();
-    }
-
-#ifdef USE_PIXEL_DEBUG_COUNTERS
-    SentPixels         = SentPixelsCount;
-    PixelsToSend       = pixel_count;
-    IntensityBytesSent = 0;
-#endif // def USE_PIXEL_DEBUG_COUNTERS
+        // DEBUG_V(String(F("Error: Unsupported Color Order: '")) + color_order + F("'. Using RGB"));
+        strcpy(color_order, String(F ("rgb")).c_str());
+        ColorOffsets.offset.r = 0;
+        ColorOffsets.offset.g = 1;
+        ColorOffsets.offset.b = 2;
+        ColorOffsets.offset.w = 3;
+        NumIntensityBytesPerPixel = 3;
+    } // default
 
-    // NumIntensityBytesPerPixel = 1;
-    ReportNewFrame();
+    // DEBUG_V (String ("NumIntensityBytesPerPixel: ") + String (NumIntensityBytesPerPixel));
 
     // DEBUG_END;
-} // StartNewFrame
+} // updateColorOrderOffsets
 
 //----------------------------------------------------------------------------
-void c_OutputPixel::SetIntensityDataWidth(uint32_t DataWidth)
+/*
+*   Translate a color order string into the offset of each color within a
+*   pixel. Returns false if the color order is not supported.
+*/
+bool c_OutputPixel::GetColorOrderOffsets (String ColorOrder, ColorOffsets_t & Offsets, uint32_t & NumBytes)
 {
-    uint32_t IntensityMaxValue = (1 << DataWidth);
-    IntensityMultiplier = IntensityMaxValue / 256;
-
-} // SetIntensityDataWidth
+    // DEBUG_START;
 
-//----------------------------------------------------------------------------
-uint32_t IRAM_ATTR c_OutputPixel::FramePrependData()
-{
-#ifdef USE_PIXEL_DEBUG_COUNTERS
-    FramePrependDataCounter++;
-#endif // def USE_PIXEL_DEBUG_COUNTERS
+    bool response = true;
 
-    uint32_t response = pFramePrependData[FramePrependDataCurrentIndex];
-    if (++FramePrependDataCurrentIndex >= FramePrependDataSize)
+    // make sure the color order is all lower case
+    ColorOrder.toLowerCase ();
+
+         if (String (F ("rgb"))  == ColorOrder) { Offsets.offset.r = 0; Offsets.offset.g = 1; Offsets.offset.b = 2; Offsets.offset.w = 3; NumBytes = 3; }
+    else if (String (F ("rbg"))  == ColorOrder) { Offsets.offset.r = 0; Offsets.offset.g = 2; Offsets.offset.b = 1; Offsets.offset.w = 3; NumBytes = 3; }
+    else if (String (F ("gbr"))  == ColorOrder) { Offsets.offset.r = 2; Offsets.offset.g = 0; Offsets.offset.b = 1; Offsets.offset.w = 3; NumBytes = 3; }
+    else if (String (F ("grb"))  == ColorOrder) { Offsets.offset.r = 1; Offsets.offset.g = 0; Offsets.offset.b = 2; Offsets.offset.w = 3; NumBytes = 3; }
+    else if (String (F ("brg"))  == ColorOrder) { Offsets.offset.r = 1; Offsets.offset.g = 2; Offsets.offset.b = 0; Offsets.offset.w = 3; NumBytes = 3; }
+    else if (String (F ("bgr"))  == ColorOrder) { Offsets.offset.r = 2; Offsets.offset.g = 1; Offsets.offset.b = 0; Offsets.offset.w = 3; NumBytes = 3; }
+    else if (String (F ("wrgb")) == ColorOrder) { Offsets.offset.r = 1; Offsets.offset.g = 2; Offsets.offset.b = 3; Offsets.offset.w = 0; NumBytes = 4; }
+    else if (String (F ("wrbg")) == ColorOrder) { Offsets.offset.r = 1; Offsets.offset.g = 3; Offsets.offset.b = 2; Offsets.offset.w = 0; NumBytes = 4; }
+    else if (String (F ("wgbr")) == ColorOrder) { Offsets.offset.r = 3; Offsets.offset.g = 1; Offsets.offset.b = 2; Offsets.offset.w = 0; NumBytes = 4; }
+    else if (String (F ("wgrb")) == ColorOrder) { Offsets.offset.r = 2; Offsets.offset.g = 1; Offsets.offset.b = 3; Offsets.offset.w = 0; NumBytes = 4; }
+    else if (String (F ("wbrg")) == ColorOrder) { Offsets.offset.r = 2; Offsets.offset.g = 3; Offsets.offset.b = 1; Offsets.offset.w = 0; NumBytes = 4; }
+    else if (String (F ("wbgr")) == ColorOrder) { Offsets.offset.r = 3; Offsets.offset.g = 2; Offsets.offset.b = 1; Offsets.offset.w = 0; NumBytes = 4; }
+    else if (String (F ("rgbw")) == ColorOrder) { Offsets.offset.r = 0; Offsets.offset.g = 1; Offsets.offset.b = 2; Offsets.offset.w = 3; NumBytes = 4; }
+    else if (String (F ("rbgw")) == ColorOrder) { Offsets.offset.r = 0; Offsets.offset.g = 2; Offsets.offset.b = 1; Offsets.offset.w = 3; NumBytes = 4; }
+    else if (String (F ("gbrw")) == ColorOrder) { Offsets.offset.r = 2; Offsets.offset.g = 0; Offsets.offset.b = 1; Offsets.offset.w = 3; NumBytes = 4; }
+    else if (String (F ("grbw")) == ColorOrder) { Offsets.offset.r = 1; Offsets.offset.g = 0; Offsets.offset.b = 2; Offsets.offset.w = 3; NumBytes = 4; }
+    else if (String (F ("brgw")) == ColorOrder) { Offsets.offset.r = 1; Offsets.offset.g = 2; Offsets.offset.b = 0; Offsets.offset.w = 3; NumBytes = 4; }
+    else if (String (F ("bgrw")) == ColorOrder) { Offsets.offset.r = 2; Offsets.offset.g = 1; Offsets.offset.b = 0; Offsets.offset.w = 3; NumBytes = 4; }
+    else
     {
-        // FramePrependDataCurrentIndex = 0;
-        if (PrependNullPixelCount)
-        {
-            FrameStateFuncPtr = &c_OutputPixel::PixelPrependNulls;
-        }
-        else
-        {
-            SetStartingSendPixelState();
-        }
-        // PixelIntensityCurrentIndex = 0;
-        // PixelPrependDataCurrentIndex = 0;
-        // PixelIntensityCurrentColor = 0;
-
+        response = false;
     }
+
+    // DEBUG_END;
     return response;
-}
+
+} // GetColorOrderOffsets
 
 //----------------------------------------------------------------------------
-uint32_t IRAM_ATTR c_OutputPixel::PixelPrependNulls()
+/*
+*   Build a table that translates an input pixel ID into the ID of the pixel
+*   that gets the data after the zig zag processing has been applied.
+*   Without zig zag the translation is 1:1 and no table is needed.
+*/
+void c_OutputPixel::updatePixelRemapTable ()
 {
-    uint32_t response = 0x00;
-    do // once
+    // DEBUG_START;
+
+    PixelStride = PixelGroupSize * NumIntensityBytesPerPixel * BytesPerIntensity;
+
+    if (nullptr != pPixelRemapTable)
     {
-#ifdef USE_PIXEL_DEBUG_COUNTERS
-        PixelPrependNullsCounter++;
-#endif // def USE_PIXEL_DEBUG_COUNTERS
+        free (pPixelRemapTable);
+        pPixelRemapTable = nullptr;
+    }
+    PixelRemapTableSize = 0;
 
-        if (PixelPrependDataCurrentIndex < PixelPrependDataSize)
+    do // once
+    {
+        if (2 > zig_size)
         {
-            response = PixelPrependData[PixelPrependDataCurrentIndex++] * IntensityMultiplier;
+            // DEBUG_V ("No remap needed");
             break;
         }
 
-        // has the pixel completed?
-        if (++PixelIntensityCurrentIndex < NumIntensityBytesPerPixel)
+        // one entry per pixel as seen by the input side
+        uint32_t NumInputPixels = (pixel_count + PixelGroupSize - 1) / PixelGroupSize;
+        if ((0 == NumInputPixels) || (NumInputPixels > uint32_t(uint16_t(-1))))
         {
             break;
         }
 
-        // pixel is complete. Move to the next one
-        PixelIntensityCurrentIndex = 0;
-        PixelPrependDataCurrentIndex = 0;
-        PixelIntensityCurrentColor = 0;
-
-        if (++PrependNullPixelCurrentCount < PrependNullPixelCount)
+        pPixelRemapTable = (uint16_t*)malloc (NumInputPixels * sizeof (uint16_t));
+        if (nullptr == pPixelRemapTable)
         {
+            // WriteChannelData will fall back to calculating each offset
+            logcon (CN_stars + String (F (" Could not allocate the pixel remap table ")) + CN_stars);
             break;
         }
+        PixelRemapTableSize = NumInputPixels;
 
-        // no more null pixels to send
-        // PrependNullPixelCurrentCount = 0;
-        SetStartingSendPixelState();
+        for (uint32_t PixelId = 0; PixelId < NumInputPixels; ++PixelId)
+        {
+            pPixelRemapTable[PixelId] = uint16_t (ZigZagPixelId (PixelId, zig_size));
+        }
 
     } while (false);
 
-    return response;
+    // DEBUG_V (String ("PixelRemapTableSize: ") + String (PixelRemapTableSize));
+
+    updateSegmentMap ();
+
+    // DEBUG_END;
+} // updatePixelRemapTable
+
+//----------------------------------------------------------------------------
+/*
+*   Build a table that translates each input intensity used by the virtual
+*   segments into the first intensity it drives in the output buffer. The
+*   direction, color order and grouping of each segment are applied here so
+*   that WriteChannelData only has to do a lookup.
+*   Where segments use the same input channels the last segment wins.
+*/
+void c_OutputPixel::updateSegmentMap ()
+{
+    // DEBUG_START;
+
+    if (nullptr != pSegmentMap)
+    {
+        free (pSegmentMap);
+        pSegmentMap = nullptr;
+    }
+    SegmentMapSize = 0;
+
+    do // once
+    {
+        if (0 == NumSegments)
+        {
+            // DEBUG_V ("No segments");
+            break;
+        }
+
+        // segments that reach past the last channel an output can have are ignored.
+        // SetSegmentConfig keeps the start and count small enough that this cannot wrap
+        auto SegmentFits = [this] (const Segment_t & Segment)
+        {
+            uint32_t NumInputPixels = (Segment.PixelCount + Segment.GroupSize - 1) / Segment.GroupSize;
+            return (Segment.StartChannel + (NumInputPixels * NumIntensityBytesPerPixel * InputBytesPerIntensity)) <= OM_MAX_TOTAL_CHANNELS;
+        };
+
+        // how many input intensities do the segments use?
+        uint32_t MapSize = 0;
+        for (uint32_t SegmentId = 0; SegmentId < NumSegments; ++SegmentId)
+        {
+            Segment_t & Segment = pSegments[SegmentId];
+            if (!SegmentFits (Segment))
+            {
+                logcon (CN_stars + String (F (" The segment at channel ")) + String (Segment.StartChannel) + F (" does not fit in the output channels. Segment ignored ") + CN_stars);
+                continue;
+            }
+
+            // every pixel on a string has the same number of colors
+            uint32_t SegmentNumBytes = 0;
+            if (!GetColorOrderOffsets (String (Segment.ColorOrder), Segment.ColorOffsets, SegmentNumBytes) ||
+                (SegmentNumBytes != NumIntensityBytesPerPixel))
+            {
+                strcpy (Segment.ColorOrder, color_order);
+                Segment.ColorOffsets = ColorOffsets;
+            }
+
+            uint32_t NumInputPixels = (Segment.PixelCount + Segment.GroupSize - 1) / Segment.GroupSize;
+            MapSize = max (MapSize, (Segment.StartChannel / InputBytesPerIntensity) + (NumInputPixels * NumIntensityBytesPerPixel));
+        }
+
+        if (0 == MapSize)
+        {
+            break;
+        }
+
+        pSegmentMap = (SegmentMapEntry_t*)malloc (MapSize * sizeof (SegmentMapEntry_t));
+        if (nullptr == pSegmentMap)
+        {
+            logcon (CN_stars + String (F (" Could not allocate the segment map. Segments are disabled ")) + CN_stars);
+            break;
+        }
+        memset (pSegmentMap, 0x00, MapSize * sizeof (SegmentMapEntry_t));
+        SegmentMapSize = MapSize;
+
+        uint32_t FirstPixelId = 0;
+        for (uint32_t SegmentId = 0; SegmentId < NumSegments; ++SegmentId)
+        {
+            Segment_t & Segment = pSegments[SegmentId];
+            if (!SegmentFits (Segment))
+            {
+                continue;
+            }
+            uint32_t NumInputPixels = (Segment.PixelCount + Segment.GroupSize - 1) / Segment.GroupSize;
+            SegmentMapEntry_t * pEntry = &pSegmentMap[Segment.StartChannel / InputBytesPerIntensity];
+
+            for (uint32_t InputPixelId = 0; InputPixelId < NumInputPixels; ++InputPixelId)
+            {
+                uint32_t GroupStart = InputPixelId * Segment.GroupSize;
+                uint32_t GroupCount = min (Segment.GroupSize, Segment.PixelCount - GroupStart);
+                uint32_t PixelId    = FirstPixelId + ((Segment.Reverse) ? (Segment.PixelCount - GroupStart - GroupCount) : GroupStart);
+
+                // do not run off the end of the physical string
+                GroupCount = (PixelId < pixel_count) ? min (GroupCount, pixel_count - PixelId) : 0;
+
+                for (uint32_t ColorIndex = 0; ColorIndex < NumIntensityBytesPerPixel; ++ColorIndex, ++pEntry)
+                {
+                    pEntry->IntensityOffset = uint16_t ((PixelId * NumIntensityBytesPerPixel) + Segment.ColorOffsets.Array[ColorIndex]);
+                    pEntry->SegmentId       = uint8_t (SegmentId);
+                    pEntry->GroupCount      = uint8_t (GroupCount);
+                }
+            }
+
+            FirstPixelId += Segment.PixelCount;
+        }
+
+        if (FirstPixelId > pixel_count)
+        {
+            logcon (CN_stars + String (F (" The segments use more pixels than the output has. Extra pixels are ignored ")) + CN_stars);
+        }
+
+    } while (false);
+
+    // DEBUG_V (String ("SegmentMapSize: ") + String (SegmentMapSize));
+
+    // DEBUG_END;
+} // updateSegmentMap
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::SetSegmentConfig (ArduinoJson::JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    NumSegments = 0;
+    if (nullptr != pSegments)
+    {
+        free (pSegments);
+        pSegments = nullptr;
+    }
+
+    do // once
+    {
+        JsonArray JsonSegmentList = jsonConfig[(char*)CN_segments];
+        if (!JsonSegmentList || (0 == JsonSegmentList.size ()))
+        {
+            // DEBUG_V ("No segments configured");
+            break;
+        }
+
+        uint32_t NumConfiguredSegments = JsonSegmentList.size ();
+        if (NumConfiguredSegments > PIXEL_MAX_SEGMENTS)
+        {
+            logcon (CN_stars + String (F (" Too many segments. Using the first ")) + String (PIXEL_MAX_SEGMENTS) + " " + CN_stars);
+            NumConfiguredSegments = PIXEL_MAX_SEGMENTS;
+        }
+
+        pSegments = (Segment_t*)malloc (NumConfiguredSegments * sizeof (Segment_t));
+        if (nullptr == pSegments)
+        {
+            logcon (CN_stars + String (F (" Could not allocate the segment list. Segments are disabled ")) + CN_stars);
+            break;
+        }
+
+        for (JsonVariant SegmentData : JsonSegmentList)
+        {
+            if (NumSegments >= NumConfiguredSegments)
+            {
+                break;
+            }
+
+            JsonObject JsonSegmentData = SegmentData.as<JsonObject> ();
+            Segment_t & Segment = pSegments[NumSegments];
+            memset (&Segment, 0x00, sizeof (Segment));
+
+            Segment.GroupSize = 1;
+            Segment.Gamma     = gamma;
+            strcpy (Segment.ColorOrder, color_order);
+
+            setFromJSON (Segment.StartChannel, JsonSegmentData, CN_start_channel);
+            setFromJSON (Segment.PixelCount,   JsonSegmentData, CN_count);
+            setFromJSON (Segment.GroupSize,    JsonSegmentData, CN_group_size);
+            setFromJSON (Segment.Reverse,      JsonSegmentData, CN_reverse);
+            setFromJSON (Segment.Gamma,        JsonSegmentData, CN_gamma);
+            setFromJSON (Segment.ColorOrder,   JsonSegmentData, CN_color_order);
+
+            Segment.ColorOrder[sizeof (Segment.ColorOrder) - 1] = '\0';
+            Segment.GroupSize = constrain (Segment.GroupSize, uint32_t (1), uint32_t (uint8_t (-1)));
+            if (Segment.Gamma <= 0)
+            {
+                Segment.Gamma = 2.2;
+            }
+
+            if (0 == Segment.PixelCount)
+            {
+                // DEBUG_V ("Skipping empty segment");
+                continue;
+            }
+
+            // keep the map size sums well away from wrapping. updateSegmentMap drops the segments that do not fit
+            if ((Segment.StartChannel >= OM_MAX_TOTAL_CHANNELS) || (Segment.PixelCount > OM_MAX_TOTAL_CHANNELS))
+            {
+                logcon (CN_stars + String (F (" The segment at channel ")) + String (Segment.StartChannel) + F (" is outside of the output channels. Segment ignored ") + CN_stars);
+                continue;
+            }
+            ++NumSegments;
+        }
+
+        if (0 == NumSegments)
+        {
+            free (pSegments);
+            pSegments = nullptr;
+        }
+
+    } while (false);
+
+    // DEBUG_V (String ("NumSegments: ") + String (NumSegments));
+
+    // DEBUG_END;
+} // SetSegmentConfig
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::GetSegmentConfig (ArduinoJson::JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    JsonArray JsonSegmentList = jsonConfig[(char*)CN_segments].to<JsonArray> ();
+
+    for (uint32_t SegmentId = 0; SegmentId < NumSegments; ++SegmentId)
+    {
+        Segment_t & Segment = pSegments[SegmentId];
+        JsonObject JsonSegmentData = JsonSegmentList.add<JsonObject> ();
+
+        JsonWrite(JsonSegmentData, CN_start_channel, Segment.StartChannel);
+        JsonWrite(JsonSegmentData, CN_count,         Segment.PixelCount);
+        JsonWrite(JsonSegmentData, CN_group_size,    Segment.GroupSize);
+        JsonWrite(JsonSegmentData, CN_reverse,       Segment.Reverse);
+        JsonWrite(JsonSegmentData, CN_gamma,         serialized(String(Segment.Gamma, 2)));
+        JsonWrite(JsonSegmentData, CN_color_order,   Segment.ColorOrder);
+    }
+
+    // DEBUG_END;
+} // GetSegmentConfig
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::SetColorCorrectionConfig (ArduinoJson::JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    float   Matrix[9]       = { 1.0, 0.0, 0.0,
+                                0.0, 1.0, 0.0,
+                                0.0, 0.0, 1.0 };
+    uint8_t WhitePoint[3]   = { 255, 255, 255 };
+    bool    WhiteExtract    = false;
+
+    JsonArray JsonMatrix = jsonConfig[(char*)CN_color_matrix];
+    if (JsonMatrix && (9 == JsonMatrix.size ()))
+    {
+        for (uint32_t Index = 0; Index < 9; ++Index)
+        {
+            Matrix[Index] = JsonMatrix[Index].as<float> ();
+        }
+    }
+
+    JsonArray JsonWhitePoint = jsonConfig[(char*)CN_white_point];
+    if (JsonWhitePoint && (3 == JsonWhitePoint.size ()))
+    {
+        for (uint32_t Index = 0; Index < 3; ++Index)
+        {
+            WhitePoint[Index] = uint8_t (constrain (JsonWhitePoint[Index].as<uint32_t> (), uint32_t (1), uint32_t (255)));
+        }
+    }
+
+    setFromJSON (WhiteExtract, jsonConfig, CN_white_extract);
+
+    bool MatrixIsIdentity = true;
+    for (uint32_t Index = 0; Index < 9; ++Index)
+    {
+        MatrixIsIdentity = MatrixIsIdentity && (Matrix[Index] == ((0 == (Index % 4)) ? 1.0 : 0.0));
+    }
+
+    do // once
+    {
+        if (MatrixIsIdentity && !WhiteExtract)
+        {
+            // DEBUG_V ("No color correction");
+            if (nullptr != pColorCorrection)
+            {
+                free (pColorCorrection);
+                pColorCorrection = nullptr;
+            }
+            break;
+        }
+
+        if (nullptr == pColorCorrection)
+        {
+            pColorCorrection = (ColorCorrection_t*)malloc (sizeof (ColorCorrection_t));
+            if (nullptr == pColorCorrection)
+            {
+                logcon (CN_stars + String (F (" Could not allocate the color correction data. Color correction is disabled ")) + CN_stars);
+                break;
+            }
+        }
+
+        memcpy (pColorCorrection->Matrix,     Matrix,     sizeof (pColorCorrection->Matrix));
+        memcpy (pColorCorrection->WhitePoint, WhitePoint, sizeof (pColorCorrection->WhitePoint));
+        pColorCorrection->WhiteExtract = WhiteExtract;
+
+    } while (false);
+
+    // DEBUG_END;
+} // SetColorCorrectionConfig
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::GetColorCorrectionConfig (ArduinoJson::JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    JsonArray JsonMatrix = jsonConfig[(char*)CN_color_matrix].to<JsonArray> ();
+    for (uint32_t Index = 0; Index < 9; ++Index)
+    {
+        float Value = (nullptr != pColorCorrection) ? pColorCorrection->Matrix[Index] : ((0 == (Index % 4)) ? 1.0 : 0.0);
+        JsonMatrix.add (serialized (String (Value, 3)));
+    }
+
+    JsonArray JsonWhitePoint = jsonConfig[(char*)CN_white_point].to<JsonArray> ();
+    for (uint32_t Index = 0; Index < 3; ++Index)
+    {
+        JsonWhitePoint.add ((nullptr != pColorCorrection) ? pColorCorrection->WhitePoint[Index] : 255);
+    }
+
+    JsonWrite(jsonConfig, CN_white_extract, (nullptr != pColorCorrection) && pColorCorrection->WhiteExtract);
+
+    // DEBUG_END;
+} // GetColorCorrectionConfig
+
+//----------------------------------------------------------------------------
+/*
+*   Convert the color correction settings into the fixed point values used
+*   by the ingest pass. White is only extracted for four color pixels with
+*   8 bit input and no segments. The input then has three channels per pixel.
+*/
+void c_OutputPixel::updateColorCorrection ()
+{
+    // DEBUG_START;
+
+    NumInputChannelsPerPixel = NumIntensityBytesPerPixel;
+
+    do // once
+    {
+        if (nullptr == pColorCorrection)
+        {
+            // DEBUG_V ("No color correction");
+            break;
+        }
+
+        ColorCorrection_t & ColorCorrection = *pColorCorrection;
+
+        ColorCorrection.MatrixIsIdentity = true;
+        for (uint32_t Index = 0; Index < 9; ++Index)
+        {
+            float Value = constrain (ColorCorrection.Matrix[Index] * 256.0, -32768.0, 32767.0);
+            ColorCorrection.MatrixQ8[Index] = int16_t ((Value < 0) ? (Value - 0.5) : (Value + 0.5));
+            ColorCorrection.MatrixIsIdentity = ColorCorrection.MatrixIsIdentity &&
+                (ColorCorrection.MatrixQ8[Index] == ((0 == (Index % 4)) ? 256 : 0));
+        }
+
+        for (uint32_t Index = 0; Index < 3; ++Index)
+        {
+            ColorCorrection.WhiteScale[Index] = uint16_t (65280 / ColorCorrection.WhitePoint[Index]);
+        }
+
+        ColorCorrection.PartialPixelId = uint32_t (-1);
+
+        if (ColorCorrection.WhiteExtract && (4 == NumIntensityBytesPerPixel) && (1 == InputBytesPerIntensity) && (0 == NumSegments))
+        {
+            NumInputChannelsPerPixel = 3;
+        }
+
+    } while (false);
+
+    // DEBUG_V (String ("NumInputChannelsPerPixel: ") + String (NumInputChannelsPerPixel));
+
+    // DEBUG_END;
+} // updateColorCorrection
+
+//----------------------------------------------------------------------------
+bool c_OutputPixel::validate ()
+{
+    // DEBUG_START;
+    bool response = true;
+
+    if (zig_size > pixel_count)
+    {
+        logcon (CN_stars + String (F (" Requested ZigZag size count was too high. Setting to ")) + pixel_count + " " + CN_stars);
+        zig_size = pixel_count;
+        response = false;
+    }
+    else if (2 > zig_size)
+    {
+        zig_size = 1;
+    }
+
+    // Default gamma value
+    if (gamma <= 0)
+    {
+        gamma = 2.2;
+        response = false;
+    }
+
+    // Max brightness value
+    if (brightness > 100)
+    {
+        brightness = 100;
+        // DEBUG_V (String ("brightness: ") + String (brightness));
+        response = false;
+    }
+
+    // DEBUG_END;
+    return response;
+
+} // validate
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::SetFrameDurration (float _IntensityBitTimeInUs, uint16_t BlockSize, float BlockDelayUs)
+{
+    // DEBUG_START;
+    if (0 == BlockSize) { BlockSize = 1; }
+
+    IntensityBitTimeInUs = _IntensityBitTimeInUs;
+
+    float TotalIntensityBytes       = OutputBufferSize;
+    float TotalNullBytes            = (PrependNullPixelCount + AppendNullPixelCount) * NumIntensityBytesPerPixel * BytesPerIntensity;
+    float TotalBytesOfIntensityData = (TotalIntensityBytes + TotalNullBytes + FramePrependDataSize);
+    float TotalBits                 = TotalBytesOfIntensityData * 8.0;
+    uint16_t NumBlocks              = uint16_t (TotalBytesOfIntensityData / float (BlockSize));
+    int TotalBlockDelayUs           = int (float (NumBlocks) * BlockDelayUs);
+
+    ActualFrameDurationMicroSec = (IntensityBitTimeInUs * TotalBits) + InterFrameGapInMicroSec + TotalBlockDelayUs;
+    FrameDurationInMicroSec = max(uint32_t(25000), ActualFrameDurationMicroSec);
+    
+    // DEBUG_V (String ("           OutputBufferSize: ") + String (OutputBufferSize));
+    // DEBUG_V (String ("             PixelGroupSize: ") + String (PixelGroupSize));
+    // DEBUG_V (String ("        TotalIntensityBytes: ") + String (TotalIntensityBytes));
+    // DEBUG_V (String ("      PrependNullPixelCount: ") + String (PrependNullPixelCount));
+    // DEBUG_V (String ("       AppendNullPixelCount: ") + String (AppendNullPixelCount));
+    // DEBUG_V (String ("  NumIntensityBytesPerPixel: ") + String (NumIntensityBytesPerPixel));
+    // DEBUG_V (String ("             TotalNullBytes: ") + String (TotalNullBytes));
+    // DEBUG_V (String ("       FramePrependDataSize: ") + String (FramePrependDataSize));
+    // DEBUG_V (String ("  TotalBytesOfIntensityData: ") + String (TotalBytesOfIntensityData));
+    // DEBUG_V (String ("                  TotalBits: ") + String (TotalBits));
+    // DEBUG_V (String ("                  BlockSize: ") + String (BlockSize));
+    // DEBUG_V (String ("                  NumBlocks: ") + String (NumBlocks));
+    // DEBUG_V (String ("               BlockDelayUs: ") + String (BlockDelayUs));
+    // DEBUG_V (String ("          TotalBlockDelayUs: ") + String (TotalBlockDelayUs));
+    // DEBUG_V (String ("       IntensityBitTimeInUs: ") + String (IntensityBitTimeInUs));
+    // DEBUG_V (String ("    InterFrameGapInMicroSec: ") + String (InterFrameGapInMicroSec));
+    // DEBUG_V (String ("ActualFrameDurationMicroSec: ") + String (ActualFrameDurationMicroSec));
+    // DEBUG_V (String (" FrameDurationInMicroSec: ") + String (FrameDurationInMicroSec));
+
+    // DEBUG_END;
+
+} // SetInterframeGap
+
+//----------------------------------------------------------------------------
+void IRAM_ATTR c_OutputPixel::SetStartingSendPixelState()
+{
+    if(PixelPrependDataSize)
+    {
+        FrameStateFuncPtr = &c_OutputPixel::PixelSendPrependIntensity;
+    }
+    else
+    {
+#ifdef SUPPORT_OutputType_GECE
+        if (OutputType == OTYPE_t::OutputType_GECE)
+        {
+            FrameStateFuncPtr = &c_OutputPixel::PixelSendGECEIntensity;
+        }
+        else
+        {
+            FrameStateFuncPtr = &c_OutputPixel::PixelSendIntensity;
+        }
+#else
+        FrameStateFuncPtr = &c_OutputPixel::PixelSendIntensity;
+#endif // def SUPPORT_OutputType_GECE
+    }
+
+} // SetStartingSendPixelState
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::StartNewFrame ()
+{
+    // DEBUG_START;
+
+#ifdef USE_PIXEL_DEBUG_COUNTERS
+    if (ISR_MoreDataToSend ())
+    {
+        AbortFrameCounter++;
+    }
+    FrameStartCounter++;
+#endif // def USE_PIXEL_DEBUG_COUNTERS
+
+    NextPixelToSend = LatchFrontBuffer();
+    FramePrependDataCurrentIndex    = 0;
+    FrameAppendDataCurrentIndex     = 0;
+    SentPixelsCount                 = 0;
+    PixelIntensityCurrentIndex      = 0;
+    PixelIntensityCurrentColor      = 0;
+    PrependNullPixelCurrentCount    = 0;
+    AppendNullPixelCurrentCount     = 0;
+    PixelPrependDataCurrentIndex    = 0;
+    GECEPixelId                     = 0;
+
+    if(FramePrependDataSize)
+    {
+        FrameStateFuncPtr = &c_OutputPixel::FramePrependData;
+    }
+    else if (PrependNullPixelCount)
+    {
+        FrameStateFuncPtr = &c_OutputPixel::PixelPrependNulls;
+    }
+    else
+    {
+        SetStartingSendPixelState ();
+    }
+
+#ifdef USE_PIXEL_DEBUG_COUNTERS
+    SentPixels         = SentPixelsCount;
+    PixelsToSend       = pixel_count;
+    IntensityBytesSent = 0;
+#endif // def USE_PIXEL_DEBUG_COUNTERS
+
+    // scale the whole frame if it would draw more than the power budget
+    PowerScale = PIXEL_POWER_SCALE_NONE;
+    if (PowerLimitMa)
+    {
+        // the sum that goes with the bank latched for this frame
+        uint32_t Bank = LatchedFrameBank;
+        uint32_t SumToSend = (OM_NO_FRAME_BANK == Bank) ? IntensitySum : BankIntensitySum[Bank];
+        EstimatedCurrentMa = uint32_t ((uint64_t (SumToSend) * CurrentPerIntensityQ16) >> 16);
+        if (EstimatedCurrentMa > PowerLimitMa)
+        {
+            PowerScale = (PowerLimitMa * PIXEL_POWER_SCALE_NONE) / EstimatedCurrentMa;
+        }
+        PowerInvertMask = InvertMask & ((2 == BytesPerIntensity) ? 0xffff : 0xff);
+    }
+
+    // NumIntensityBytesPerPixel = 1;
+    ReportNewFrame();
+
+    // DEBUG_END;
+} // StartNewFrame
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::SetIntensityDataWidth(uint32_t DataWidth)
+{
+    uint32_t IntensityMaxValue = (1 << DataWidth);
+    IntensityMultiplier = IntensityMaxValue / 256;
+    BytesPerIntensity = (8 < DataWidth) ? 2 : 1;
+
+    updateIntensityWidth ();
+    updateGammaTable ();
+    updateDitherTables ();
+    updateColorCorrection ();
+    updatePixelRemapTable ();
+
+} // SetIntensityDataWidth
+
+//----------------------------------------------------------------------------
+uint32_t IRAM_ATTR c_OutputPixel::FramePrependData()
+{
+#ifdef USE_PIXEL_DEBUG_COUNTERS
+    FramePrependDataCounter++;
+#endif // def USE_PIXEL_DEBUG_COUNTERS
+
+    uint32_t response = pFramePrependData[FramePrependDataCurrentIndex] ^ InvertMask;
+    if (++FramePrependDataCurrentIndex >= FramePrependDataSize)
+    {
+        // FramePrependDataCurrentIndex = 0;
+        if (PrependNullPixelCount)
+        {
+            FrameStateFuncPtr = &c_OutputPixel::PixelPrependNulls;
+        }
+        else
+        {
+            SetStartingSendPixelState();
+        }
+        // PixelIntensityCurrentIndex = 0;
+        // PixelPrependDataCurrentIndex = 0;
+        // PixelIntensityCurrentColor = 0;
+
+    }
+    return response;
+}
+
+//----------------------------------------------------------------------------
+uint32_t IRAM_ATTR c_OutputPixel::PixelPrependNulls()
+{
+    uint32_t response = InvertMask;
+    do // once
+    {
+#ifdef USE_PIXEL_DEBUG_COUNTERS
+        PixelPrependNullsCounter++;
+#endif // def USE_PIXEL_DEBUG_COUNTERS
+
+        if (PixelPrependDataCurrentIndex < PixelPrependDataSize)
+        {
+            response = (PixelPrependData[PixelPrependDataCurrentIndex++] * IntensityMultiplier) ^ InvertMask;
+            break;
+        }
+
+        // has the pixel completed?
+        if (++PixelIntensityCurrentIndex < NumIntensityBytesPerPixel)
+        {
+            break;
+        }
+
+        // pixel is complete. Move to the next one
+        PixelIntensityCurrentIndex = 0;
+        PixelPrependDataCurrentIndex = 0;
+        PixelIntensityCurrentColor = 0;
+
+        if (++PrependNullPixelCurrentCount < PrependNullPixelCount)
+        {
+            break;
+        }
+
+        // no more null pixels to send
+        // PrependNullPixelCurrentCount = 0;
+        SetStartingSendPixelState();
+
+    } while (false);
+
+    return response;
 } // fPixelPrependNulls
 
 //----------------------------------------------------------------------------
@@ -524,7 +1174,7 @@ uint32_t IRAM_ATTR c_OutputPixel::PixelSendPrependIntensity()
         IntensityBytesSent++;
 #endif // def USE_PIXEL_DEBUG_COUNTERS
 
-    uint32_t response = PixelPrependData[PixelPrependDataCurrentIndex++];
+    uint32_t response = PixelPrependData[PixelPrependDataCurrentIndex++] ^ InvertMask;
 
         // pixel prepend goes here
         if (PixelPrependDataCurrentIndex >= PixelPrependDataSize)
@@ -567,9 +1217,11 @@ uint32_t IRAM_ATTR c_OutputPixel::PixelSendGECEIntensity()
     // build a GECE intensity frame
     response = GECEBrightness;
     response |= GECE_SET_ADDRESS(GECEPixelId++);
-    response |= GECE_SET_RED(GetIntensityData());
-    response |= GECE_SET_GREEN(GetIntensityData());
-    response |= GECE_SET_BLUE(GetIntensityData());
+    // the intensities are stored inverted. The frame is inverted as a whole.
+    response |= GECE_SET_RED(GetIntensityData() ^ uint8_t(InvertMask));
+    response |= GECE_SET_GREEN(GetIntensityData() ^ uint8_t(InvertMask));
+    response |= GECE_SET_BLUE(GetIntensityData() ^ uint8_t(InvertMask));
+    response ^= InvertMask;
 #ifdef USE_PIXEL_DEBUG_COUNTERS
     LastGECEdataSent = response;
     NumGECEdataSent++;
@@ -593,7 +1245,7 @@ uint32_t IRAM_ATTR c_OutputPixel::PixelSendIntensity()
 //----------------------------------------------------------------------------
 uint32_t IRAM_ATTR c_OutputPixel::PixelAppendNulls()
 {
-    uint32_t response = 0x00;
+    uint32_t response = InvertMask;
     do // once
     {
 #ifdef USE_PIXEL_DEBUG_COUNTERS
@@ -602,7 +1254,7 @@ uint32_t IRAM_ATTR c_OutputPixel::PixelAppendNulls()
 // pixel prepend goes here
         if (PixelPrependDataCurrentIndex < PixelPrependDataSize)
         {
-            response = PixelPrependData[PixelPrependDataCurrentIndex++];
+            response = PixelPrependData[PixelPrependDataCurrentIndex++] ^ InvertMask;
             break;
         }
 
@@ -640,7 +1292,7 @@ uint32_t IRAM_ATTR c_OutputPixel::FrameAppendData()
     FrameAppendDataCounter++;
 #endif // def USE_PIXEL_DEBUG_COUNTERS
 
-    uint32_t response = pFrameAppendData[FrameAppendDataCurrentIndex];
+    uint32_t response = pFrameAppendData[FrameAppendDataCurrentIndex] ^ InvertMask;
 
     if (++FrameAppendDataCurrentIndex >= FrameAppendDataSize)
     {
@@ -656,7 +1308,7 @@ uint32_t IRAM_ATTR c_OutputPixel::FrameDone()
 #ifdef USE_PIXEL_DEBUG_COUNTERS
     FrameDoneCounter++;
 #endif // def USE_PIXEL_DEBUG_COUNTERS
-    return 0x00;
+    return InvertMask;
 }
 
 //----------------------------------------------------------------------------
@@ -671,23 +1323,96 @@ bool IRAM_ATTR c_OutputPixel::ISR_GetNextIntensityToSend (uint32_t &DataToSend)
     }
 #endif // def USE_PIXEL_DEBUG_COUNTERS
 
+    // inversion has already been applied by the individual states
     DataToSend = (this->*FrameStateFuncPtr)();
 
-    if (InvertData)
+    return ISR_MoreDataToSend();
+
+} // NextIntensityToSend
+
+//----------------------------------------------------------------------------
+/*
+*   Fill up to MaxCount intensities in one call. Runs of pixel data are
+*   copied straight from the buffer. Only the state changes (frame and pixel
+*   prepend data, null pixels, the last intensity in the buffer) go through
+*   the state machine.
+*/
+uint32_t IRAM_ATTR c_OutputPixel::ISR_GetNextIntensitiesToSend (uint32_t * pDataToSend, uint32_t MaxCount)
+{
+    uint32_t Count = 0;
+
+    while ((Count < MaxCount) && ISR_MoreDataToSend())
     {
-        DataToSend = ~DataToSend;
+        if ((&c_OutputPixel::PixelSendIntensity == FrameStateFuncPtr) && (0 == PixelPrependDataSize))
+        {
+            // leave the last intensity in the buffer to the state machine
+            uint32_t RemainingIntensities = (OutputBufferSize - PixelIntensityCurrentIndex) / BytesPerIntensity;
+            uint32_t RunLength = (1 < RemainingIntensities) ? min (MaxCount - Count, RemainingIntensities - 1) : 0;
+
+            if (RunLength)
+            {
+                uint8_t * pData = &NextPixelToSend[PixelIntensityCurrentIndex];
+                if (2 == BytesPerIntensity)
+                {
+                    for (uint32_t Index = 0; Index < RunLength; ++Index, pData += 2)
+                    {
+                        pDataToSend[Count++] = (uint32_t(pData[0]) << 8) | pData[1];
+                    }
+                }
+                else
+                {
+                    for (uint32_t Index = 0; Index < RunLength; ++Index)
+                    {
+                        pDataToSend[Count++] = *pData++;
+                    }
+                }
+
+                if (PIXEL_POWER_SCALE_NONE != PowerScale)
+                {
+                    for (uint32_t Index = Count - RunLength; Index < Count; ++Index)
+                    {
+                        pDataToSend[Index] = ScaleIntensity (pDataToSend[Index]);
+                    }
+                }
+
+                PixelIntensityCurrentIndex += RunLength * BytesPerIntensity;
+                PixelIntensityCurrentColor  = (PixelIntensityCurrentColor + RunLength) % NumIntensityBytesPerPixel;
+#ifdef USE_PIXEL_DEBUG_COUNTERS
+                PixelSendIntensityCounter += RunLength;
+                IntensityBytesSent += RunLength;
+#endif // def USE_PIXEL_DEBUG_COUNTERS
+                continue;
+            }
+        }
+
+        // inversion has already been applied by the individual states
+        pDataToSend[Count++] = (this->*FrameStateFuncPtr)();
     }
 
-    return ISR_MoreDataToSend();
+#ifdef USE_PIXEL_DEBUG_COUNTERS
+    GetNextIntensityToSendCounter += Count;
+#endif // def USE_PIXEL_DEBUG_COUNTERS
 
-} // NextIntensityToSend
+    return Count;
+
+} // ISR_GetNextIntensitiesToSend
 
 //----------------------------------------------------------------------------
 uint32_t IRAM_ATTR c_OutputPixel::GetIntensityData()
 {
     uint32_t response = 0;
 
-    response = pOutputBuffer[PixelIntensityCurrentIndex];
+    // NextPixelToSend was latched at the start of the frame
+    response = NextPixelToSend[PixelIntensityCurrentIndex];
+    if (2 == BytesPerIntensity)
+    {
+        response = (response << 8) | NextPixelToSend[++PixelIntensityCurrentIndex];
+    }
+
+    if (PIXEL_POWER_SCALE_NONE != PowerScale)
+    {
+        response = ScaleIntensity (response);
+    }
 
     ++PixelIntensityCurrentIndex;
     if (PixelIntensityCurrentIndex >= OutputBufferSize)
@@ -734,28 +1459,7 @@ inline uint32_t c_OutputPixel::CalculateIntensityOffset(uint32_t ChannelId)
     uint32_t PixelId = ChannelId / uint32_t(NumIntensityBytesPerPixel);
     // DEBUG_V(String("               PixelId0: ") + String(PixelId));
 
-    // are we doing a zig zag operation?
-    if ((zig_size > 1) && (PixelId >= zig_size))
-    {
-        // DEBUG_V(String("               PixelId1: ") + String(PixelId));
-        // DEBUG_V(String("               zig_size: ") + String(zig_size));
-        uint32_t ZigZagGroupId = PixelId / zig_size;
-        // DEBUG_V(String("          ZigZagGroupId: ") + String(ZigZagGroupId));
-
-        // is this a backwards group
-        if (0 != (ZigZagGroupId & 0x1))
-        {
-            // DEBUG_V("Backwards Group");
-            uint32_t zigoffset = PixelId % zig_size;
-            // DEBUG_V(String("              zigoffset: ") + String(zigoffset));
-            uint32_t BaseGroupPixelId = ZigZagGroupId * zig_size;
-            // DEBUG_V(String("      BaseGroupPixelId1: ") + String(BaseGroupPixelId));
-            PixelId = BaseGroupPixelId + (zig_size - 1) - zigoffset;
-            // DEBUG_V(String("      BaseGroupPixelId2: ") + String(BaseGroupPixelId));
-            // DEBUG_V(String("                PixelId: 0x") + String(PixelId, HEX));
-        }
-        // DEBUG_V(String("               PixelId2: ") + String(PixelId));
-    }
+    PixelId = ZigZagPixelId (PixelId, zig_size);
     // DEBUG_V(String("          Final PixelId: ") + String(PixelId));
 
     uint32_t ColorOrderIndex = ChannelId % NumIntensityBytesPerPixel;
@@ -781,6 +1485,18 @@ inline uint32_t c_OutputPixel::CalculateIntensityOffset(uint32_t ChannelId)
 
 } // CalculateIntensityOffset
 
+//----------------------------------------------------------------------------
+inline uint8_t c_OutputPixel::DitherIntensity(uint8_t * pBuffer, uint32_t Intensity)
+{
+    // add the fraction left over from the previous frame. Cannot overflow 16 bits.
+    uint8_t & Residue = pDitherResidue[pBuffer - pBackBuffer];
+    uint32_t Value = Intensity + Residue;
+    Residue = uint8_t(Value);
+
+    return uint8_t((Value >> 8) ^ InvertMask);
+
+} // DitherIntensity
+
 //----------------------------------------------------------------------------
 void c_OutputPixel::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
 {
@@ -795,48 +1511,403 @@ void c_OutputPixel::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCo
     // DEBUG_V(String("         StartChannelId: 0x") + String(StartChannelId, HEX));
     // DEBUG_V(String("           ChannelCount: 0x") + String(ChannelCount, HEX));
 
-    uint32_t EndChannelId = StartChannelId + ChannelCount;
-    uint32_t SourceDataIndex = 0;
-    for (uint32_t currentChannelId = StartChannelId; currentChannelId < EndChannelId; ++currentChannelId, ++SourceDataIndex)
+    if ((nullptr != pColorCorrection) && (1 == InputBytesPerIntensity))
+    {
+        WriteColorCorrectedData (StartChannelId, ChannelCount, pSourceData);
+    }
+    else
+    {
+        WriteIntensityData (StartChannelId, ChannelCount, pSourceData);
+    }
+
+    // DEBUG_END;
+
+} // WriteChannelData
+
+//----------------------------------------------------------------------------
+/*
+*   Put input intensities (one per output color) into the output buffer
+*   using the gamma, group, zig zag, segment and color order settings.
+*/
+void c_OutputPixel::WriteIntensityData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
+{
+    // DEBUG_START;
+
+    if (2 == InputBytesPerIntensity)
+    {
+        WriteWideIntensityData (StartChannelId, ChannelCount, pSourceData);
+        return;
+    }
+
+    if (nullptr != pSegmentMap)
     {
-        uint32_t CurrentIntensityData = gamma_table[pSourceData[SourceDataIndex]];
-        CurrentIntensityData = uint8_t((uint32_t(CurrentIntensityData) * AdjustedBrightness) >> 8);
-        uint32_t CalculatedChannelId = CalculateIntensityOffset(currentChannelId);
-        uint8_t *pBuffer = &pOutputBuffer[CalculatedChannelId];
+        WriteSegmentData (StartChannelId, ChannelCount, pSourceData);
+        return;
+    }
+
+    if (2 == BytesPerIntensity)
+    {
+        WriteChannelData16 (StartChannelId, ChannelCount, pSourceData);
+        return;
+    }
+
+    // never write past the end of our part of the buffer
+    uint8_t * pBufferEnd = &pBackBuffer[OutputBufferSize];
+
+    // Walk the pixels instead of calculating the offset of each channel.
+    // Only the first channel needs the divide.
+    uint32_t PixelId = StartChannelId / NumIntensityBytesPerPixel;
+    uint32_t ColorOrderIndex = StartChannelId - (PixelId * NumIntensityBytesPerPixel);
+    uint8_t * pPixelBase = nullptr;
+
+    for (uint32_t SourceDataIndex = 0; SourceDataIndex < ChannelCount; ++SourceDataIndex)
+    {
+        if (nullptr == pPixelBase)
+        {
+            if (PixelId < PixelRemapTableSize)
+            {
+                pPixelBase = &pBackBuffer[uint32_t(pPixelRemapTable[PixelId]) * PixelStride];
+            }
+            else if (1 < zig_size)
+            {
+                // no table available (or not large enough). Do it the long way.
+                pPixelBase = &pBackBuffer[CalculateIntensityOffset(PixelId * NumIntensityBytesPerPixel) - ColorOffsets.Array[0]];
+            }
+            else
+            {
+                pPixelBase = &pBackBuffer[PixelId * PixelStride];
+            }
+        }
+
+        uint8_t CurrentIntensityData = gamma_table[pSourceData[SourceDataIndex]];
+        uint8_t *pBuffer = pPixelBase + ColorOffsets.Array[ColorOrderIndex];
         for(uint32_t CurrentGroupIndex = 0; CurrentGroupIndex < PixelGroupSize; ++CurrentGroupIndex)
         {
-            // DEBUG_V(String("      CurrentGroupIndex: 0x") + String(CurrentGroupIndex, HEX));
-            // DEBUG_V(String("    CalculatedChannelId: 0x") + String(CalculatedChannelId, HEX));
-            if(uint32_t(pBuffer) >= uint32_t(&pOutputBuffer[OutputBufferSize]))
+            if(pBuffer >= pBufferEnd)
             {
                 // DEBUG_V("This write is beyond the end of the Output buffer for this channel");
-                // DEBUG_V(String("      CalculatedChannelId: ") + String(CalculatedChannelId));
-                // DEBUG_V(String("NumIntensityBytesPerPixel: ") + String(NumIntensityBytesPerPixel));
-                // DEBUG_V(String("           PixelGroupSize: ") + String(PixelGroupSize));
-                // DEBUG_V(String("                Last Data: ") + String((CalculatedChannelId + (NumIntensityBytesPerPixel * PixelGroupSize))));
-                // DEBUG_V(String("         OutputBufferSize: ") + String(OutputBufferSize));
                 break;
             }
 
-            if(uint32_t(pBuffer) >= uint32_t(&(OutputMgr.GetBufferAddress()[OutputMgr.GetBufferSize()])))
+            if (nullptr != pDitherTable)
             {
-                DEBUG_V("This write is beyond the end of the Global Output buffer");
-                DEBUG_V(String("      CalculatedChannelId: ") + String(CalculatedChannelId));
-                DEBUG_V(String("NumIntensityBytesPerPixel: ") + String(NumIntensityBytesPerPixel));
-                DEBUG_V(String("           PixelGroupSize: ") + String(PixelGroupSize));
-                DEBUG_V(String("                Last Data: ") + String((CalculatedChannelId + (NumIntensityBytesPerPixel * PixelGroupSize))));
-                DEBUG_V(String("         OutputBufferSize: ") + String(OutputBufferSize));
-                break;
+                CurrentIntensityData = DitherIntensity(pBuffer, pDitherTable[pSourceData[SourceDataIndex]]);
             }
-
+            IntensitySum += uint8_t(CurrentIntensityData ^ InvertMask) - uint8_t(*pBuffer ^ InvertMask);
             *pBuffer = CurrentIntensityData;
             pBuffer += NumIntensityBytesPerPixel;
         }
+
+        // move to the next color / pixel
+        if (++ColorOrderIndex >= NumIntensityBytesPerPixel)
+        {
+            ColorOrderIndex = 0;
+            ++PixelId;
+            pPixelBase = nullptr;
+        }
     }
 
+    MarkDirty ();
+
     // DEBUG_END;
 
-} // WriteChannelData
+} // WriteIntensityData
+
+//----------------------------------------------------------------------------
+/*
+*   Same walk as WriteChannelData for outputs that store 16 bits per
+*   intensity. Eight bit input values are expanded to 16 bits (v * 257) and
+*   16 bit inputs send the high byte first. Both then interpolate on the
+*   16 bit gamma table.
+*/
+void c_OutputPixel::WriteChannelData16(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
+{
+    // DEBUG_START;
+
+    // never write past the end of our part of the buffer
+    uint8_t * pBufferEnd = &pBackBuffer[OutputBufferSize];
+
+    uint32_t IntensityId = StartChannelId / InputBytesPerIntensity;
+    uint32_t PixelId = IntensityId / NumIntensityBytesPerPixel;
+    uint32_t ColorOrderIndex = IntensityId - (PixelId * NumIntensityBytesPerPixel);
+    uint32_t IntensityStep = NumIntensityBytesPerPixel * BytesPerIntensity;
+    uint8_t * pPixelBase = nullptr;
+
+    for (uint32_t SourceDataIndex = 0; (SourceDataIndex + InputBytesPerIntensity) <= ChannelCount; SourceDataIndex += InputBytesPerIntensity)
+    {
+        if (nullptr == pPixelBase)
+        {
+            if (PixelId < PixelRemapTableSize)
+            {
+                pPixelBase = &pBackBuffer[uint32_t(pPixelRemapTable[PixelId]) * PixelStride];
+            }
+            else if (1 < zig_size)
+            {
+                // no table available (or not large enough). Do it the long way.
+                pPixelBase = &pBackBuffer[(CalculateIntensityOffset(PixelId * NumIntensityBytesPerPixel) - ColorOffsets.Array[0]) * BytesPerIntensity];
+            }
+            else
+            {
+                pPixelBase = &pBackBuffer[PixelId * PixelStride];
+            }
+        }
+
+        uint32_t Value = pSourceData[SourceDataIndex];
+        Value = (2 == InputBytesPerIntensity) ? ((Value << 8) | pSourceData[SourceDataIndex + 1]) : (Value * 257);
+        uint32_t Index = Value >> 8;
+        uint32_t Intensity = pGammaTable16[Index] + (((pGammaTable16[Index + 1] - pGammaTable16[Index]) * (Value & 0xff)) >> 8);
+        Intensity ^= InvertMask;
+
+        uint8_t *pBuffer = pPixelBase + (ColorOffsets.Array[ColorOrderIndex] * BytesPerIntensity);
+        for(uint32_t CurrentGroupIndex = 0; CurrentGroupIndex < PixelGroupSize; ++CurrentGroupIndex)
+        {
+            if((pBuffer + 1) >= pBufferEnd)
+            {
+                // DEBUG_V("This write is beyond the end of the Output buffer for this channel");
+                break;
+            }
+
+            IntensitySum += uint8_t((Intensity >> 8) ^ InvertMask) - uint8_t(pBuffer[0] ^ InvertMask);
+            pBuffer[0] = uint8_t(Intensity >> 8);
+            pBuffer[1] = uint8_t(Intensity);
+            pBuffer += IntensityStep;
+        }
+
+        // move to the next color / pixel
+        if (++ColorOrderIndex >= NumIntensityBytesPerPixel)
+        {
+            ColorOrderIndex = 0;
+            ++PixelId;
+            pPixelBase = nullptr;
+        }
+    }
+
+    MarkDirty ();
+
+    // DEBUG_END;
+
+} // WriteChannelData16
+
+//----------------------------------------------------------------------------
+/*
+*   16 bit inputs send each intensity as two channels, high byte first. A
+*   write that starts or ends on an odd channel (universe boundary) splits an
+*   intensity. The high byte is kept until the next write brings the low
+*   byte, as long as the writes arrive in order.
+*/
+void c_OutputPixel::WriteWideIntensityData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
+{
+    // DEBUG_START;
+
+    if ((StartChannelId & 1) && ChannelCount)
+    {
+        // finish the intensity started by the previous write
+        if (PartialIntensityChannelId == (StartChannelId - 1))
+        {
+            uint8_t Intensity[2] = { PartialIntensityHighByte, pSourceData[0] };
+            WriteAlignedWideIntensityData (StartChannelId - 1, sizeof (Intensity), Intensity);
+        }
+        ++StartChannelId;
+        --ChannelCount;
+        ++pSourceData;
+    }
+    PartialIntensityChannelId = uint32_t (-1);
+
+    if (ChannelCount & 1)
+    {
+        // the low byte of the last intensity comes with the next write
+        --ChannelCount;
+        PartialIntensityHighByte  = pSourceData[ChannelCount];
+        PartialIntensityChannelId = StartChannelId + ChannelCount;
+    }
+
+    if (ChannelCount)
+    {
+        WriteAlignedWideIntensityData (StartChannelId, ChannelCount, pSourceData);
+    }
+
+    // DEBUG_END;
+
+} // WriteWideIntensityData
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::WriteAlignedWideIntensityData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
+{
+    // DEBUG_START;
+
+    if (nullptr != pSegmentMap)
+    {
+        WriteSegmentData (StartChannelId, ChannelCount, pSourceData);
+    }
+    else
+    {
+        WriteChannelData16 (StartChannelId, ChannelCount, pSourceData);
+    }
+
+    // DEBUG_END;
+
+} // WriteAlignedWideIntensityData
+
+//----------------------------------------------------------------------------
+/*
+*   Write path used when virtual segments are configured. All of the mapping
+*   work was done when the segment map was built. Dithering is not applied
+*   and 16 bit outputs use the output gamma for every segment.
+*/
+void c_OutputPixel::WriteSegmentData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
+{
+    // DEBUG_START;
+
+    // never write past the end of our part of the buffer
+    uint8_t * pBufferEnd = &pBackBuffer[OutputBufferSize];
+    uint32_t IntensityStep = NumIntensityBytesPerPixel * BytesPerIntensity;
+    uint32_t IntensityId = StartChannelId / InputBytesPerIntensity;
+
+    for (uint32_t SourceDataIndex = 0;
+         ((SourceDataIndex + InputBytesPerIntensity) <= ChannelCount) && (IntensityId < SegmentMapSize);
+         SourceDataIndex += InputBytesPerIntensity, ++IntensityId)
+    {
+        SegmentMapEntry_t & Entry = pSegmentMap[IntensityId];
+        uint8_t * pBuffer = &pBackBuffer[uint32_t(Entry.IntensityOffset) * BytesPerIntensity];
+
+        if (1 == BytesPerIntensity)
+        {
+            uint8_t Intensity = pSegments[Entry.SegmentId].GammaTable[pSourceData[SourceDataIndex]];
+            for (uint32_t CurrentGroupIndex = 0; (CurrentGroupIndex < Entry.GroupCount) && (pBuffer < pBufferEnd); ++CurrentGroupIndex)
+            {
+                IntensitySum += uint8_t(Intensity ^ InvertMask) - uint8_t(*pBuffer ^ InvertMask);
+                *pBuffer = Intensity;
+                pBuffer += IntensityStep;
+            }
+        }
+        else
+        {
+            uint32_t Value = pSourceData[SourceDataIndex];
+            Value = (2 == InputBytesPerIntensity) ? ((Value << 8) | pSourceData[SourceDataIndex + 1]) : (Value * 257);
+            uint32_t Index = Value >> 8;
+            uint32_t Intensity = pGammaTable16[Index] + (((pGammaTable16[Index + 1] - pGammaTable16[Index]) * (Value & 0xff)) >> 8);
+            Intensity ^= InvertMask;
+
+            for (uint32_t CurrentGroupIndex = 0; (CurrentGroupIndex < Entry.GroupCount) && ((pBuffer + 1) < pBufferEnd); ++CurrentGroupIndex)
+            {
+                IntensitySum += uint8_t((Intensity >> 8) ^ InvertMask) - uint8_t(pBuffer[0] ^ InvertMask);
+                pBuffer[0] = uint8_t(Intensity >> 8);
+                pBuffer[1] = uint8_t(Intensity);
+                pBuffer += IntensityStep;
+            }
+        }
+    }
+
+    MarkDirty ();
+
+    // DEBUG_END;
+
+} // WriteSegmentData
+
+//----------------------------------------------------------------------------
+inline void c_OutputPixel::ColorCorrectPixel (const uint8_t * pInput, uint8_t * pOutput)
+{
+    ColorCorrection_t & ColorCorrection = *pColorCorrection;
+    int32_t Color[3] = { pInput[0], pInput[1], pInput[2] };
+
+    if (!ColorCorrection.MatrixIsIdentity)
+    {
+        const int16_t * pRow = ColorCorrection.MatrixQ8;
+        for (uint32_t Row = 0; Row < 3; ++Row, pRow += 3)
+        {
+            int32_t Value = ((pRow[0] * int32_t(pInput[0])) + (pRow[1] * int32_t(pInput[1])) + (pRow[2] * int32_t(pInput[2])) + 128) >> 8;
+            Color[Row] = constrain (Value, int32_t (0), int32_t (255));
+        }
+    }
+
+    if (NumInputChannelsPerPixel < NumIntensityBytesPerPixel)
+    {
+        // the most white that fits under all three colors
+        uint32_t White = 255;
+        for (uint32_t Index = 0; Index < 3; ++Index)
+        {
+            White = min (White, (uint32_t (Color[Index]) * ColorCorrection.WhiteScale[Index]) >> 8);
+        }
+
+        // take out what the white LED provides. (x * 257 + 32768) >> 16 is x / 255
+        for (uint32_t Index = 0; Index < 3; ++Index)
+        {
+            Color[Index] = max (int32_t (0), Color[Index] - int32_t (((White * ColorCorrection.WhitePoint[Index] * 257) + 32768) >> 16));
+        }
+        pOutput[3] = uint8_t (White);
+    }
+    else if (4 == NumIntensityBytesPerPixel)
+    {
+        pOutput[3] = pInput[3];
+    }
+
+    pOutput[0] = uint8_t (Color[0]);
+    pOutput[1] = uint8_t (Color[1]);
+    pOutput[2] = uint8_t (Color[2]);
+
+} // ColorCorrectPixel
+
+//----------------------------------------------------------------------------
+/*
+*   Color correction needs whole pixels. Input pixels are collected, corrected
+*   in batches and then written like any other intensity data. A pixel that
+*   is split across two writes (universe boundary) is completed by the next
+*   write as long as the writes arrive in order.
+*/
+void c_OutputPixel::WriteColorCorrectedData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData)
+{
+    // DEBUG_START;
+
+    ColorCorrection_t & ColorCorrection = *pColorCorrection;
+    uint8_t  CorrectedData[PIXEL_COLOR_CORRECTION_BATCH_SIZE * 4];
+    uint8_t  Pixel[4] = { 0 };
+
+    uint32_t PixelId    = StartChannelId / NumInputChannelsPerPixel;
+    uint32_t ColorIndex = StartChannelId - (PixelId * NumInputChannelsPerPixel);
+
+    // pick up the start of a pixel from the previous write
+    if (ColorIndex && (PixelId == ColorCorrection.PartialPixelId))
+    {
+        memcpy (Pixel, ColorCorrection.PartialPixel, ColorIndex);
+    }
+    ColorCorrection.PartialPixelId = uint32_t (-1);
+
+    uint32_t FirstPixelId = PixelId;
+    uint32_t NumCorrectedPixels = 0;
+
+    for (uint32_t SourceDataIndex = 0; SourceDataIndex < ChannelCount; ++SourceDataIndex)
+    {
+        Pixel[ColorIndex] = pSourceData[SourceDataIndex];
+        if (++ColorIndex < NumInputChannelsPerPixel)
+        {
+            continue;
+        }
+        ColorIndex = 0;
+
+        ColorCorrectPixel (Pixel, &CorrectedData[NumCorrectedPixels * NumIntensityBytesPerPixel]);
+        if (++NumCorrectedPixels >= PIXEL_COLOR_CORRECTION_BATCH_SIZE)
+        {
+            WriteIntensityData (FirstPixelId * NumIntensityBytesPerPixel, NumCorrectedPixels * NumIntensityBytesPerPixel, CorrectedData);
+            FirstPixelId += NumCorrectedPixels;
+            NumCorrectedPixels = 0;
+        }
+    }
+
+    if (ColorIndex)
+    {
+        // the rest of this pixel comes with the next write
+        memcpy (ColorCorrection.PartialPixel, Pixel, ColorIndex);
+        ColorCorrection.PartialPixelId = FirstPixelId + NumCorrectedPixels;
+    }
+
+    if (NumCorrectedPixels)
+    {
+        WriteIntensityData (FirstPixelId * NumIntensityBytesPerPixel, NumCorrectedPixels * NumIntensityBytesPerPixel, CorrectedData);
+    }
+
+    // DEBUG_END;
+
+} // WriteColorCorrectedData
 
 //----------------------------------------------------------------------------
 void c_OutputPixel::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData)
@@ -848,9 +1919,44 @@ void c_OutputPixel::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCou
 
     uint32_t EndChannelId = StartChannelId + ChannelCount;
     uint32_t SourceDataIndex = 0;
+    if (nullptr != pSegmentMap)
+    {
+        for (uint32_t currentChannelId = StartChannelId; currentChannelId < EndChannelId; ++currentChannelId, ++SourceDataIndex)
+        {
+            uint32_t IntensityId = currentChannelId / InputBytesPerIntensity;
+            uint8_t CurrentIntensityData = 0;
+            if ((IntensityId < SegmentMapSize) && (0 != pSegmentMap[IntensityId].GroupCount))
+            {
+                uint32_t IntensityOffset = uint32_t(pSegmentMap[IntensityId].IntensityOffset) * BytesPerIntensity;
+                if (2 == BytesPerIntensity)
+                {
+                    CurrentIntensityData = pBackBuffer[IntensityOffset + (currentChannelId % InputBytesPerIntensity)] ^ uint8_t(InvertMask);
+                }
+                else
+                {
+                    CurrentIntensityData = pBackBuffer[IntensityOffset] ^ uint8_t(InvertMask);
+                    CurrentIntensityData = uint8_t((uint32_t(CurrentIntensityData << 8) / AdjustedBrightness));
+                }
+            }
+            pTargetData[SourceDataIndex] = CurrentIntensityData;
+        }
+        return;
+    }
+
+    if (2 == BytesPerIntensity)
+    {
+        // return the stored intensity. Eight bit inputs get the high byte.
+        for (uint32_t currentChannelId = StartChannelId; currentChannelId < EndChannelId; ++currentChannelId, ++SourceDataIndex)
+        {
+            uint32_t IntensityOffset = CalculateIntensityOffset(currentChannelId / InputBytesPerIntensity) * BytesPerIntensity;
+            pTargetData[SourceDataIndex] = pBackBuffer[IntensityOffset + (currentChannelId % InputBytesPerIntensity)] ^ uint8_t(InvertMask);
+        }
+        return;
+    }
+
     for (uint32_t currentChannelId = StartChannelId; currentChannelId < EndChannelId; ++currentChannelId, ++SourceDataIndex)
     {
-        uint8_t CurrentIntensityData = pOutputBuffer[CalculateIntensityOffset(currentChannelId)];
+        uint8_t CurrentIntensityData = pBackBuffer[CalculateIntensityOffset(currentChannelId)] ^ uint8_t(InvertMask);
         // CurrentIntensityData = gamma_table[CurrentIntensityData];
         CurrentIntensityData = uint8_t((uint32_t(CurrentIntensityData << 8) / AdjustedBrightness));
         pTargetData[SourceDataIndex] = CurrentIntensityData;
@@ -859,3 +1965,76 @@ void c_OutputPixel::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCou
     // DEBUG_END;
 
 } // ReadChannelData
+
+//----------------------------------------------------------------------------
+/*
+*   An output is identity mapped when WriteChannelData would copy the
+*   input data into the buffer without changing it. This lets the output
+*   manager bypass the per channel processing.
+*/
+bool c_OutputPixel::IsIdentityMapped()
+{
+    // DEBUG_START;
+
+    bool response = (1 == PixelGroupSize) && (2 > zig_size) && !Dither && (1 == BytesPerIntensity) && (nullptr == pSegmentMap) && (nullptr == pColorCorrection) && (0 == PowerLimitMa);
+
+    for (uint32_t ColorIndex = 0; response && (ColorIndex < NumIntensityBytesPerPixel); ++ColorIndex)
+    {
+        response = (ColorIndex == ColorOffsets.Array[ColorIndex]);
+    }
+
+    // covers gamma, brightness and data inversion
+    for (uint32_t Intensity = 0; response && (Intensity < sizeof (gamma_table)); ++Intensity)
+    {
+        response = (Intensity == gamma_table[Intensity]);
+    }
+
+    // DEBUG_V (String ("response: ") + String (response));
+
+    // DEBUG_END;
+    return response;
+
+} // IsIdentityMapped
+
+//----------------------------------------------------------------------------
+void c_OutputPixel::ClearBuffer()
+{
+    // DEBUG_START;
+
+    // an intensity of zero may not be a zero in the buffer
+    memset(pBackBuffer, gamma_table[0], OutputBufferSize);
+    IntensitySum = 0;
+    MarkDirty ();
+
+    // DEBUG_END;
+
+} // ClearBuffer
+
+//----------------------------------------------------------------------------
+/*
+*   The write functions keep the intensity sum up to date as they change the
+*   buffer. This full pass is only needed when the buffer itself changes.
+*/
+void c_OutputPixel::updateIntensitySum ()
+{
+    // DEBUG_START;
+
+    uint32_t Sum = 0;
+    if (nullptr != pBackBuffer)
+    {
+        for (uint32_t Index = 0; Index < OutputBufferSize; Index += BytesPerIntensity)
+        {
+            Sum += uint8_t(pBackBuffer[Index] ^ InvertMask);
+        }
+    }
+
+    IntensitySum = Sum;
+    for (uint32_t & BankSum : BankIntensitySum)
+    {
+        BankSum = Sum;
+    }
+
+    // DEBUG_V (String ("IntensitySum: ") + String (IntensitySum));
+
+    // DEBUG_END;
+} // updateIntensitySum
@@ -23,14 +23,9 @@
 #ifdef ARDUINO_ARCH_ESP32
 #include "output/OutputRmt.hpp"
 #include <driver/rmt.h>
-#include <vector>
-#include <cstdlib>
-#include <unordered_map>
 
-// Reusable heap buffers per c_OutputRmt instance to avoid malloc/free on every frame.
-// Keyed by pointer to the instance.
-static std::unordered_map<c_OutputRmt*, rmt_item32_t*> g_reusableBuffers;
-static std::unordered_map<c_OutputRmt*, size_t> g_reusableCapacities;
+// number of intensities pulled from the data source per call while filling the send buffer
+#define RMT_INTENSITY_BATCH_SIZE 16
 
 // forward declaration for the isr handler (not used for register operations anymore)
 static void IRAM_ATTR rmt_intr_handler(void* param) { (void)param; }
@@ -46,41 +41,62 @@ static TaskHandle_t SendFrameTaskHandle = NULL;
 static uint32_t FrameCompletes = 0;
 static uint32_t FrameTimeouts = 0;
 
-// watcher task removed: synchronous TX wait used instead
+// a frame that takes longer than this to complete is counted as a timeout and abandoned
+#define RMT_FRAME_TIMEOUT_US    (1000 * 1000)
 
 //----------------------------------------------------------------------------
-// Simple send task that polls all channels and triggers StartNextFrame()
+// Called by the RMT driver (ISR context) when a channel has sent its last item
+static void IRAM_ATTR RMT_TxEndCallback(rmt_channel_t channel, void * arg)
+{
+    (void)arg;
+
+    c_OutputRmt * pRmt = rmt_isr_ThisPtrs[(int)channel];
+    if (nullptr != pRmt)
+    {
+        pRmt->ISR_FrameSent();
+    }
+
+    if (SendFrameTaskHandle)
+    {
+        BaseType_t HigherPriorityTaskWoken = pdFALSE;
+        xTaskNotifyFromISR(SendFrameTaskHandle, (1 << uint32_t(channel)), eSetBits, &HigherPriorityTaskWoken);
+        if (pdFALSE != HigherPriorityTaskWoken)
+        {
+            portYIELD_FROM_ISR();
+        }
+    }
+} // RMT_TxEndCallback
+
+//----------------------------------------------------------------------------
+// Send task. Starts a frame on every channel that is ready and not already
+// sending, so all channels transmit in parallel. Each channel's completion
+// arrives as its bit in the task notification value.
 void RMT_Task(void *arg)
 {
     (void)arg;
     while (1)
     {
-        // yield a bit to other tasks but allow low latency
-        vTaskDelay(pdMS_TO_TICKS(1));
-
         // process all possible channels
         for (c_OutputRmt * pRmt : rmt_isr_ThisPtrs)
         {
             // do we have a driver on this channel?
             if (nullptr != pRmt)
             {
-                // invoke the channel - StartNextFrame returns true if a frame was started
-                if (pRmt->StartNextFrame())
-                {
-                    // wait for notification that the frame finished (emulates old behavior)
-                    // use an indefinite wait to avoid spurious timeouts
-                    uint32_t NotificationValue = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-                    if (1 == NotificationValue)
-                    {
-                        ++FrameCompletes;
-                    }
-                    else
-                    {
-                        ++FrameTimeouts;
-                    }
-                }
+                // a lost tx end callback would otherwise stop this channel for good
+                pRmt->CheckFrameTimeout();
+
+                // StartNextFrame skips channels that are still sending
+                pRmt->StartNextFrame();
             }
         }
+
+        // wake up early when any channel completes, otherwise poll again
+        // after a tick to pick up channels that have become ready.
+        uint32_t CompletedChannels = 0;
+        if (pdTRUE == xTaskNotifyWait(0, ULONG_MAX, &CompletedChannels, pdMS_TO_TICKS(1)))
+        {
+            FrameCompletes += __builtin_popcount(CompletedChannels);
+        }
     }
 } // RMT_Task
 
@@ -90,6 +106,7 @@ c_OutputRmt::c_OutputRmt()
 {
     memset((void *)&Intensity2Rmt[0], 0x00, sizeof(Intensity2Rmt));
     memset((void *)&SendBuffer[0], 0x00, sizeof(SendBuffer));
+    memset((void *)&NibbleXlatTable[0][0], 0x00, sizeof(NibbleXlatTable));
 
 #ifdef USE_RMT_DEBUG_COUNTERS
     memset((void *)&BitTypeCounters[0], 0x00, sizeof(BitTypeCounters));
@@ -112,19 +129,6 @@ c_OutputRmt::~c_OutputRmt()
 
         rmt_isr_ThisPtrs[(int)OutputRmtConfig.RmtChannelId] = (c_OutputRmt*)nullptr;
     }
-
-    // Free any reusable heap buffer allocated for this instance
-    auto itBuf = g_reusableBuffers.find(this);
-    if (itBuf != g_reusableBuffers.end())
-    {
-        if (itBuf->second) free(itBuf->second);
-        g_reusableBuffers.erase(itBuf);
-    }
-    auto itCap = g_reusableCapacities.find(this);
-    if (itCap != g_reusableCapacities.end())
-    {
-        g_reusableCapacities.erase(itCap);
-    }
 } // ~c_OutputRmt
 
 //----------------------------------------------------------------------------
@@ -183,7 +187,7 @@ void c_OutputRmt::Begin(OutputRmtConfig_t config, c_OutputCommon * _pParent)
 
         ResetGpio(OutputRmtConfig.DataPin);
         ESP_ERROR_CHECK(rmt_config(&RmtConfig));
-        ESP_ERROR_CHECK(rmt_driver_install(OutputRmtConfig.RmtChannelId, 0, 0));
+        InstallDriver();
 
         // --- Extended channel setup & validation ---
         {
@@ -206,7 +210,7 @@ void c_OutputRmt::Begin(OutputRmtConfig_t config, c_OutputCommon * _pParent)
             ESP_ERROR_CHECK(rmt_set_source_clk(OutputRmtConfig.RmtChannelId, RMT_BASECLK_APB));
         #endif
 
-        // reset the internal indices & buffer counters (kept for compatibility; not used)
+        // reset the send buffer indices and the encoder
         ISR_ResetRmtBlockPointers();
         memset(SendBuffer, 0, sizeof(SendBuffer));
 
@@ -214,6 +218,7 @@ void c_OutputRmt::Begin(OutputRmtConfig_t config, c_OutputCommon * _pParent)
 
         if (!SendFrameTaskHandle)
         {
+            rmt_register_tx_end_callback(RMT_TxEndCallback, nullptr);
             xTaskCreatePinnedToCore(RMT_Task, "RMT_Task", 4096, NULL, 5, &SendFrameTaskHandle, 1);
             vTaskPrioritySet(SendFrameTaskHandle, 5);
         }
@@ -224,6 +229,17 @@ void c_OutputRmt::Begin(OutputRmtConfig_t config, c_OutputCommon * _pParent)
     } while (false);
 } // Begin
 
+//----------------------------------------------------------------------------
+// InstallDriver - install the IDF channel driver and hook up the translator
+void c_OutputRmt::InstallDriver()
+{
+    ESP_ERROR_CHECK(rmt_driver_install(OutputRmtConfig.RmtChannelId, 0, 0));
+
+    // the driver calls the translator to refill the channel memory while the frame is being sent
+    ESP_ERROR_CHECK(rmt_translator_init(OutputRmtConfig.RmtChannelId, ISR_Translator));
+    ESP_ERROR_CHECK(rmt_translator_set_context(OutputRmtConfig.RmtChannelId, this));
+} // InstallDriver
+
 //----------------------------------------------------------------------------
 // UpdateBitXlatTable & Validate
 void c_OutputRmt::UpdateBitXlatTable(const CitrdsArray_t * CitrdsArray)
@@ -241,8 +257,45 @@ void c_OutputRmt::UpdateBitXlatTable(const CitrdsArray_t * CitrdsArray)
     {
         logcon(String(CN_stars) + F(" ERROR: Missing pointer to RMT bit translation values (1) ") + CN_stars);
     }
+
+    UpdateNibbleXlatTable();
 } // UpdateBitXlatTable
 
+//----------------------------------------------------------------------------
+// UpdateNibbleXlatTable - precompute the four data bit symbols for every
+// nibble value, ordered in the direction the bits are sent. Only used when
+// the intensity width is a whole number of nibbles.
+void c_OutputRmt::UpdateNibbleXlatTable()
+{
+    bool MsbFirst = (OutputRmtConfig.DataDirection == OutputRmtConfig_t::DataDirection_t::MSB2LSB);
+
+    for (uint32_t Nibble = 0; Nibble < 16; ++Nibble)
+    {
+        for (uint32_t Bit = 0; Bit < 4; ++Bit)
+        {
+            uint32_t Mask = MsbFirst ? (0x08 >> Bit) : (0x01 << Bit);
+            NibbleXlatTable[Nibble][Bit] = (Nibble & Mask) ?
+                                           Intensity2Rmt[RmtDataBitIdType_t::RMT_DATA_BIT_ONE_ID] :
+                                           Intensity2Rmt[RmtDataBitIdType_t::RMT_DATA_BIT_ZERO_ID];
+        }
+    }
+
+    UseNibbleXlatTable = (0 != OutputRmtConfig.IntensityDataWidth) &&
+                         (0 == (OutputRmtConfig.IntensityDataWidth % 4));
+} // UpdateNibbleXlatTable
+
+//----------------------------------------------------------------------------
+void c_OutputRmt::SetIntensity2Rmt(rmt_item32_t NewValue, RmtDataBitIdType_t ID)
+{
+    Intensity2Rmt[ID] = NewValue;
+
+    // keep the nibble table in step with the data bit symbols
+    if ((RmtDataBitIdType_t::RMT_DATA_BIT_ZERO_ID == ID) || (RmtDataBitIdType_t::RMT_DATA_BIT_ONE_ID == ID))
+    {
+        UpdateNibbleXlatTable();
+    }
+} // SetIntensity2Rmt
+
 bool c_OutputRmt::ValidateBitXlatTable(const CitrdsArray_t * CitrdsArray)
 {
     bool Response = true;
@@ -274,6 +327,9 @@ bool c_OutputRmt::ValidateBitXlatTable(const CitrdsArray_t * CitrdsArray)
 void c_OutputRmt::GetStatus(ArduinoJson::JsonObject& jsonStatus)
 {
     jsonStatus[F("NumRmtSlotOverruns")] = NumRmtSlotOverruns;
+    jsonStatus[F("FrameLatencyUs")]     = FrameLatencyMicroSec;
+    jsonStatus[F("MaxFrameLatencyUs")]  = MaxFrameLatencyMicroSec;
+    jsonStatus[F("FrameTimeouts")]      = FrameTimeouts;
 #ifdef USE_RMT_DEBUG_COUNTERS
     jsonStatus[F("OutputIsPaused")] = OutputIsPaused;
     JsonObject debugStatus = jsonStatus["RMT Debug"].to<JsonObject>();
@@ -316,11 +372,173 @@ void c_OutputRmt::GetStatus(ArduinoJson::JsonObject& jsonStatus)
 } // GetStatus
 
 //----------------------------------------------------------------------------
-// (Legacy) ISR_CreateIntensityData kept for API compatibility but not used by StartNewFrame
+// ISR_CreateIntensityData - encode the next part of the frame into the send
+// buffer. Stops when there is no room for another intensity value or when the
+// frame is complete.
 void IRAM_ATTR c_OutputRmt::ISR_CreateIntensityData()
 {
-    (void)0;
-}
+    uint32_t IntensityValues[RMT_INTENSITY_BATCH_SIZE];
+
+    // Restart at the top of an empty buffer. A single fill never exceeds the
+    // buffer size, so the writes below never have to wrap.
+    if (0 == NumUsedEntriesInSendBuffer)
+    {
+        SendBufferWriteIndex = 0;
+        SendBufferReadIndex = 0;
+    }
+
+    while ((EncoderState_t::EncodeDone != EncoderState) &&
+           ((RMT_SEND_BUFFER_SIZE - NumUsedEntriesInSendBuffer) >= NumRmtSlotsPerIntensityValue))
+    {
+        switch (EncoderState)
+        {
+            case EncoderState_t::EncodeFrameStart:
+            {
+                if (EncoderBitCount < OutputRmtConfig.NumIdleBits)
+                {
+                    ISR_WriteToBuffer(Intensity2Rmt[RmtDataBitIdType_t::RMT_INTERFRAME_GAP_ID].val);
+                }
+                else if (EncoderBitCount < uint32_t(OutputRmtConfig.NumIdleBits + OutputRmtConfig.NumFrameStartBits))
+                {
+                    ISR_WriteToBuffer(Intensity2Rmt[RmtDataBitIdType_t::RMT_STARTBIT_ID].val);
+                }
+                else
+                {
+                    EncoderState = EncoderState_t::EncodeIntensityData;
+                    break;
+                }
+                ++EncoderBitCount;
+                break;
+            }
+
+            case EncoderState_t::EncodeIntensityData:
+            {
+                uint32_t MaxCount = (RMT_SEND_BUFFER_SIZE - NumUsedEntriesInSendBuffer) / NumRmtSlotsPerIntensityValue;
+                if (MaxCount > RMT_INTENSITY_BATCH_SIZE)
+                {
+                    MaxCount = RMT_INTENSITY_BATCH_SIZE;
+                }
+
+                uint32_t NumIntensities = ISR_MoreDataToSend() ? ISR_GetNextIntensitiesToSend(IntensityValues, MaxCount) : 0;
+                if (0 == NumIntensities)
+                {
+                    RMT_DEBUG_COUNTER(++RanOutOfData);
+                    EncoderState = EncoderState_t::EncodeFrameEnd;
+                    EncoderBitCount = 0;
+                    break;
+                }
+                EncoderSentData = true;
+
+                if (UseNibbleXlatTable)
+                {
+                    ISR_EncodeIntensitiesByNibble(IntensityValues, NumIntensities);
+                    break;
+                }
+
+                for (uint32_t i = 0; i < NumIntensities; ++i)
+                {
+                    uint32_t IntensityValue = IntensityValues[i];
+                    uint32_t Mask = TxIntensityDataStartingMask;
+
+                    for (uint32_t b = 0; b < OutputRmtConfig.IntensityDataWidth; ++b)
+                    {
+                        ISR_WriteToBuffer((IntensityValue & Mask) ?
+                                          Intensity2Rmt[RmtDataBitIdType_t::RMT_DATA_BIT_ONE_ID].val :
+                                          Intensity2Rmt[RmtDataBitIdType_t::RMT_DATA_BIT_ZERO_ID].val);
+
+                        if (OutputRmtConfig.DataDirection == OutputRmtConfig_t::DataDirection_t::MSB2LSB)
+                        {
+                            Mask >>= 1;
+                        }
+                        else
+                        {
+                            Mask <<= 1;
+                        }
+                    }
+                    RMT_DEBUG_COUNTER(IntensityBitsSent += OutputRmtConfig.IntensityDataWidth);
+
+                    if (OutputRmtConfig.SendInterIntensityBits)
+                    {
+                        ISR_WriteToBuffer(Intensity2Rmt[RmtDataBitIdType_t::RMT_STOPBIT_ID].val);
+                    }
+                    RMT_DEBUG_COUNTER(++IntensityValuesSent);
+                }
+                break;
+            }
+
+            case EncoderState_t::EncodeFrameEnd:
+            {
+                if (0 == EncoderBitCount)
+                {
+                    if (EncoderSentData && OutputRmtConfig.SendEndOfFrameBits)
+                    {
+                        ISR_WriteToBuffer(Intensity2Rmt[RmtDataBitIdType_t::RMT_END_OF_FRAME].val);
+                    }
+                }
+                else if (EncoderBitCount <= OutputRmtConfig.NumFrameStopBits)
+                {
+                    ISR_WriteToBuffer(Intensity2Rmt[RmtDataBitIdType_t::RMT_INTERFRAME_GAP_ID].val);
+                }
+                else
+                {
+                    EncoderState = EncoderState_t::EncodeDone;
+                    break;
+                }
+                ++EncoderBitCount;
+                break;
+            }
+
+            default:
+            {
+                EncoderState = EncoderState_t::EncodeDone;
+                break;
+            }
+        } // switch
+    } // while
+} // ISR_CreateIntensityData
+
+//----------------------------------------------------------------------------
+// ISR_EncodeIntensitiesByNibble - copy four precomputed symbols per nibble into
+// the send buffer. The caller has checked that there is room for all of them.
+inline void IRAM_ATTR c_OutputRmt::ISR_EncodeIntensitiesByNibble(const uint32_t * pIntensityValues, uint32_t NumIntensities)
+{
+    rmt_item32_t * pStart = &SendBuffer[SendBufferWriteIndex];
+    rmt_item32_t * pDest  = pStart;
+    uint32_t       Width  = OutputRmtConfig.IntensityDataWidth;
+    bool           MsbFirst = (OutputRmtConfig.DataDirection == OutputRmtConfig_t::DataDirection_t::MSB2LSB);
+
+    for (uint32_t i = 0; i < NumIntensities; ++i)
+    {
+        uint32_t IntensityValue = pIntensityValues[i];
+
+        for (uint32_t n = 0; n < Width; n += 4)
+        {
+            uint32_t Shift = MsbFirst ? (Width - 4 - n) : n;
+            const rmt_item32_t * pSymbols = NibbleXlatTable[(IntensityValue >> Shift) & 0x0f];
+            pDest[0] = pSymbols[0];
+            pDest[1] = pSymbols[1];
+            pDest[2] = pSymbols[2];
+            pDest[3] = pSymbols[3];
+            pDest += 4;
+        }
+
+        if (OutputRmtConfig.SendInterIntensityBits)
+        {
+            *pDest++ = Intensity2Rmt[RmtDataBitIdType_t::RMT_STOPBIT_ID];
+        }
+    }
+
+    uint32_t NumEntriesWritten = uint32_t(pDest - pStart);
+    SendBufferWriteIndex += NumEntriesWritten;
+    if (SendBufferWriteIndex >= RMT_SEND_BUFFER_SIZE)
+    {
+        SendBufferWriteIndex = 0;
+    }
+    NumUsedEntriesInSendBuffer += NumEntriesWritten;
+
+    RMT_DEBUG_COUNTER(IntensityValuesSent += NumIntensities);
+    RMT_DEBUG_COUNTER(IntensityBitsSent += NumIntensities * Width);
+} // ISR_EncodeIntensitiesByNibble
 
 //----------------------------------------------------------------------------
 // ISR_GetNextIntensityToSend - delegate to pixel or serial source (kept)
@@ -342,6 +560,25 @@ inline bool IRAM_ATTR c_OutputRmt::ISR_GetNextIntensityToSend(uint32_t &DataToSe
 #endif // defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
 } // ISR_GetNextIntensityToSend
 
+//----------------------------------------------------------------------------
+// ISR_GetNextIntensitiesToSend - fill up to MaxCount intensities from the configured source
+inline uint32_t IRAM_ATTR c_OutputRmt::ISR_GetNextIntensitiesToSend(uint32_t * pDataToSend, uint32_t MaxCount)
+{
+    if (nullptr != OutputRmtConfig.pPixelDataSource)
+    {
+        return OutputRmtConfig.pPixelDataSource->ISR_GetNextIntensitiesToSend(pDataToSend, MaxCount);
+    }
+
+    uint32_t Count = 0;
+#if defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
+    while ((Count < MaxCount) && OutputRmtConfig.pSerialDataSource->ISR_MoreDataToSend())
+    {
+        OutputRmtConfig.pSerialDataSource->ISR_GetNextIntensityToSend(pDataToSend[Count++]);
+    }
+#endif // defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
+    return Count;
+} // ISR_GetNextIntensitiesToSend
+
 //----------------------------------------------------------------------------
 // ISR_Handler kept for API compatibility
 void IRAM_ATTR c_OutputRmt::ISR_Handler(uint32_t isrFlags)
@@ -368,14 +605,18 @@ inline bool IRAM_ATTR c_OutputRmt::ISR_MoreDataToSend()
 } // ISR_MoreDataToSend
 
 //----------------------------------------------------------------------------
-// ISR_ResetRmtBlockPointers (legacy; no ring buffer used anymore)
+// ISR_ResetRmtBlockPointers - empty the send buffer and rewind the encoder to the start of a frame
 inline void IRAM_ATTR c_OutputRmt::ISR_ResetRmtBlockPointers()
 {
     RmtBufferWriteIndex = 0;
     SendBufferWriteIndex = 0;
     SendBufferReadIndex = 0;
     NumUsedEntriesInSendBuffer = 0;
-}
+
+    EncoderState = EncoderState_t::EncodeFrameStart;
+    EncoderBitCount = 0;
+    EncoderSentData = false;
+} // ISR_ResetRmtBlockPointers
 
 //----------------------------------------------------------------------------
 // ISR_StartNewDataFrame - call source StartNewFrame
@@ -394,26 +635,134 @@ inline void IRAM_ATTR c_OutputRmt::ISR_StartNewDataFrame()
 } // StartNewDataFrame
 
 //----------------------------------------------------------------------------
-// ISR_TransferIntensityDataToRMT (no-op for software buffer approach)
-void IRAM_ATTR c_OutputRmt::ISR_TransferIntensityDataToRMT(uint32_t MaxNumEntriesToTransfer)
+// ISR_Translator - called by the RMT driver to fill the channel memory. The
+// first call asks for a full block, each threshold interrupt after that asks
+// for half a block. The source is a single placeholder byte that is reported
+// as consumed once the whole frame has been handed to the driver.
+void IRAM_ATTR c_OutputRmt::ISR_Translator(const void * pSource, rmt_item32_t * pDest, size_t SourceSize, size_t WantedNum, size_t * pTranslatedSize, size_t * pItemNum)
 {
-    (void)MaxNumEntriesToTransfer;
+    (void)pSource;
+    uint32_t StartTime = micros();
+
+    c_OutputRmt * pThis = nullptr;
+    rmt_translator_get_context(pItemNum, (void **)&pThis);
+
+    *pItemNum = pThis->ISR_TransferIntensityDataToRMT(pDest, WantedNum);
+
+    // anything less than a full request tells the driver the frame is complete
+    bool FrameIsComplete = (EncoderState_t::EncodeDone == pThis->EncoderState) &&
+                           (0 == pThis->NumUsedEntriesInSendBuffer);
+    *pTranslatedSize = FrameIsComplete ? SourceSize : 0;
+
+    if (nullptr != pThis->pParent)
+    {
+        pThis->pParent->ReportIsrTime(micros() - StartTime);
+    }
+} // ISR_Translator
+
+//----------------------------------------------------------------------------
+// ISR_TransferIntensityDataToRMT - move up to MaxNumEntriesToTransfer items
+// from the send buffer to the driver, encoding more of the frame as needed.
+inline uint32_t IRAM_ATTR c_OutputRmt::ISR_TransferIntensityDataToRMT(rmt_item32_t * pDest, uint32_t MaxNumEntriesToTransfer)
+{
+    uint32_t NumEntriesTransferred = 0;
+
+    while (NumEntriesTransferred < MaxNumEntriesToTransfer)
+    {
+        if (0 == NumUsedEntriesInSendBuffer)
+        {
+            ISR_CreateIntensityData();
+            if (0 == NumUsedEntriesInSendBuffer)
+            {
+                // frame is complete
+                break;
+            }
+        }
+
+        pDest[NumEntriesTransferred++] = SendBuffer[SendBufferReadIndex];
+        if (++SendBufferReadIndex >= RMT_SEND_BUFFER_SIZE)
+        {
+            SendBufferReadIndex = 0;
+        }
+        --NumUsedEntriesInSendBuffer;
+    }
+
+    RMT_DEBUG_COUNTER(RmtEntriesTransfered += NumEntriesTransferred);
+    RMT_DEBUG_COUNTER(++RmtXmtFills);
+
+    return NumEntriesTransferred;
 } // ISR_TransferIntensityDataToRMT
 
 //----------------------------------------------------------------------------
-// ISR_WriteToBuffer kept for compatibility (writes into legacy SendBuffer)
+// ISR_WriteToBuffer - append one RMT item to the send buffer
 inline void IRAM_ATTR c_OutputRmt::ISR_WriteToBuffer(uint32_t value)
 {
-    if (NumUsedEntriesInSendBuffer >= (NUM_RMT_SLOTS - 2))
+    if (NumUsedEntriesInSendBuffer >= RMT_SEND_BUFFER_SIZE)
     {
         ++NumRmtSlotOverruns;
         return;
     }
 
     SendBuffer[SendBufferWriteIndex].val = value;
-    SendBufferWriteIndex = (SendBufferWriteIndex + 1) & (NUM_RMT_SLOTS - 1);
+    if (++SendBufferWriteIndex >= RMT_SEND_BUFFER_SIZE)
+    {
+        SendBufferWriteIndex = 0;
+    }
     ++NumUsedEntriesInSendBuffer;
-}
+} // ISR_WriteToBuffer
+
+//----------------------------------------------------------------------------
+// ISR_FrameSent - the driver has sent the last item of the frame on this channel
+void IRAM_ATTR c_OutputRmt::ISR_FrameSent()
+{
+    if (FrameInProgress)
+    {
+        FrameLatencyMicroSec = micros() - FrameKickoffMicroSec;
+        MaxFrameLatencyMicroSec = max(MaxFrameLatencyMicroSec, FrameLatencyMicroSec);
+        if (FrameLatencyMicroSec > RMT_FRAME_TIMEOUT_US)
+        {
+            ++FrameTimeouts;
+        }
+
+        if (pParent)
+            pParent->ReportFrameSent();
+
+        FrameInProgress = false;
+    }
+} // ISR_FrameSent
+
+//----------------------------------------------------------------------------
+// CheckFrameTimeout - runs in the send task. Gives up on a frame whose tx end
+// callback never arrived so the channel can start the next one. The driver
+// only gives its tx semaphore back from the tx end interrupt and the next
+// rmt_write_sample would wait on it forever, blocking every channel. Stopping
+// the channel does not give it back, so the channel driver is reinstalled.
+void c_OutputRmt::CheckFrameTimeout()
+{
+    if (FrameInProgress && ((micros() - FrameKickoffMicroSec) > RMT_FRAME_TIMEOUT_US))
+    {
+        rmt_channel_t Channel = (rmt_channel_t)OutputRmtConfig.RmtChannelId;
+        rmt_tx_stop(Channel);
+        rmt_driver_uninstall(Channel);
+        InstallDriver();
+        ISR_ResetRmtBlockPointers();
+
+        FrameInProgress = false;
+        ++FrameTimeouts;
+
+        // the frame will not report that it was sent
+        if (pParent)
+            pParent->ReleaseFrontBuffer();
+    }
+} // CheckFrameTimeout
+
+//----------------------------------------------------------------------------
+// TxIsIdle - the driver has finished the last frame and will not block the
+// next rmt_write_sample
+bool c_OutputRmt::TxIsIdle()
+{
+    return (!FrameInProgress) && (ESP_OK == rmt_wait_tx_done((rmt_channel_t)OutputRmtConfig.RmtChannelId, 0));
+} // TxIsIdle
 
 //----------------------------------------------------------------------------
 // PauseOutput
@@ -432,7 +781,8 @@ void c_OutputRmt::PauseOutput(bool PauseOutput)
 } // PauseOutput
 
 //----------------------------------------------------------------------------
-// StartNewFrame - build frame in a linear vector and call rmt_write_items (non-blocking)
+// StartNewFrame - start the source and let the driver stream the frame out of
+// the encoder. Returns as soon as the transmission has started.
 bool c_OutputRmt::StartNewFrame()
 {
     bool ok = true;
@@ -451,200 +801,30 @@ bool c_OutputRmt::StartNewFrame()
 
         // Start frame on source
         ISR_StartNewDataFrame();
+        ISR_ResetRmtBlockPointers();
 
-        // --- Linear RMT item list ---
-        std::vector<rmt_item32_t> items;
-        uint32_t est_items = 0;
-
-        // --- Estimate size dynamically based on pixel source ---
-        if (OutputRmtConfig.pPixelDataSource)
-        {
-            uint32_t numPixels = 0;
-            uint32_t bytesPerPixel = 3;
-            uint32_t groupSize = 1;
-            uint32_t colorOrderLen = 0;
-
-            // Use modern ArduinoJson API
-            JsonDocument cfgDoc;
-            cfgDoc.clear();
-            JsonObject cfg = cfgDoc.to<JsonObject>();
-
-            OutputRmtConfig.pPixelDataSource->GetConfig(cfg);
-
-            // pixel_count
-            if (cfg[CN_pixel_count].is<uint32_t>())
-                numPixels = cfg[CN_pixel_count].as<uint32_t>();
-            else if (cfg["pixel_count"].is<uint32_t>())
-                numPixels = cfg["pixel_count"].as<uint32_t>();
-
-            // group_size
-            if (cfg[CN_group_size].is<uint32_t>())
-                groupSize = cfg[CN_group_size].as<uint32_t>();
-            else if (cfg["group_size"].is<uint32_t>())
-                groupSize = cfg["group_size"].as<uint32_t>();
-
-            // color_order
-			if (cfg[CN_color_order].is<const char*>())
-			{
-				JsonString js = cfg[CN_color_order].as<JsonString>();
-				colorOrderLen = js.size();
-			}
-			else if (cfg["color_order"].is<const char*>())
-			{
-				JsonString js = cfg["color_order"].as<JsonString>();
-				colorOrderLen = js.size();
-			}
-
-            // bytes per pixel
-            if (colorOrderLen == 0)
-                bytesPerPixel = 3 * groupSize;
-            else
-                bytesPerPixel = colorOrderLen * groupSize;
-
-            uint32_t bitsPerIntensity = OutputRmtConfig.IntensityDataWidth;
-
-            est_items = numPixels * bytesPerPixel * bitsPerIntensity;
-        }
-
-        // Add frame overhead
-        est_items += OutputRmtConfig.NumIdleBits
-                   + OutputRmtConfig.NumFrameStartBits
-                   + OutputRmtConfig.NumFrameStopBits
-                   + 64;
-
-        if (est_items < 256) est_items = 256;
-        items.reserve(est_items);
-
-        // --- Build frame items ---
-
-        // Idle bits
-        for (uint32_t i = 0; i < OutputRmtConfig.NumIdleBits; ++i)
-            items.push_back(Intensity2Rmt[RmtDataBitIdType_t::RMT_INTERFRAME_GAP_ID]);
-
-        // Start bits
-        for (uint32_t i = 0; i < OutputRmtConfig.NumFrameStartBits; ++i)
-            items.push_back(Intensity2Rmt[RmtDataBitIdType_t::RMT_STARTBIT_ID]);
-
-        // Pixel data
-        bool more = ISR_MoreDataToSend();
-        while (more)
-        {
-            uint32_t intensityByte = 0;
-            bool moreAfter = ISR_GetNextIntensityToSend(intensityByte);
-
-            uint32_t mask = (OutputRmtConfig.DataDirection == OutputRmtConfig_t::DataDirection_t::MSB2LSB)
-                ? (1u << (OutputRmtConfig.IntensityDataWidth - 1))
-                : 1u;
-
-            for (uint32_t b = 0; b < OutputRmtConfig.IntensityDataWidth; ++b)
-            {
-                bool isOne = (intensityByte & mask) != 0;
-
-                items.push_back(isOne
-                    ? Intensity2Rmt[RmtDataBitIdType_t::RMT_DATA_BIT_ONE_ID]
-                    : Intensity2Rmt[RmtDataBitIdType_t::RMT_DATA_BIT_ZERO_ID]);
-
-#ifdef USE_RMT_DEBUG_COUNTERS
-                IntensityBitsSent++;
-#endif
-
-                if (OutputRmtConfig.DataDirection == OutputRmtConfig_t::DataDirection_t::MSB2LSB)
-                    mask >>= 1;
-                else
-                    mask <<= 1;
-            }
-
-            if (OutputRmtConfig.SendInterIntensityBits)
-                items.push_back(Intensity2Rmt[RmtDataBitIdType_t::RMT_STOPBIT_ID]);
-
-#ifdef USE_RMT_DEBUG_COUNTERS
-            IntensityValuesSent++;
-#endif
-
-            more = moreAfter;
-
-            if (!more)
-            {
-                if (OutputRmtConfig.SendEndOfFrameBits)
-                    items.push_back(Intensity2Rmt[RmtDataBitIdType_t::RMT_END_OF_FRAME]);
-                break;
-            }
-        }
-
-        // Stop bits
-        for (uint32_t i = 0; i < OutputRmtConfig.NumFrameStopBits; ++i)
-            items.push_back(Intensity2Rmt[RmtDataBitIdType_t::RMT_INTERFRAME_GAP_ID]);
-
-        // Terminator
-        rmt_item32_t endItem;
-        endItem.val = 0;
-        items.push_back(endItem);
-
-        // --- Reusable heap buffer (Performance optimization) ---
-		size_t count = items.size();
-
-		// local capacity variable
-		size_t reusableCapacity = 0;
-
-		rmt_item32_t* heap_items = nullptr;
-
-		// read existing capacity
-		auto itC = g_reusableCapacities.find(this);
-		if (itC != g_reusableCapacities.end())
-			reusableCapacity = itC->second;
-
-		// read existing buffer
-		auto itB = g_reusableBuffers.find(this);
-		if (itB != g_reusableBuffers.end())
-			heap_items = itB->second;
-
-		// reallocate if too small
-		if (reusableCapacity < count)
-		{
-			if (heap_items)
-				free(heap_items);
-
-			size_t newCapacity = count + 64;
-
-			heap_items = static_cast<rmt_item32_t*>(
-				malloc(newCapacity * sizeof(rmt_item32_t))
-			);
-
-			if (!heap_items)
-			{
-				logcon("[RMT] ERROR: malloc failed");
-				ok = false;
-				break;
-			}
-
-			g_reusableBuffers[this] = heap_items;
-			g_reusableCapacities[this] = newCapacity;
-
-		}
-
-		// copy items to heap buffer
-		memcpy(heap_items, items.data(), count * sizeof(rmt_item32_t));
+        if (pParent)
+            pParent->ReportFrameBuilt();
 
         // --- Send frame ---
-        esp_err_t e = rmt_write_items(
+        // The translator encodes the frame half a channel block at a time as the data goes out.
+        FrameKickoffMicroSec = micros();
+        FrameInProgress = true;
+        esp_err_t e = rmt_write_sample(
             (rmt_channel_t)OutputRmtConfig.RmtChannelId,
-            heap_items,
-            count,
+            &EncoderSample,
+            sizeof(EncoderSample),
             false
         );
 
         if (e != ESP_OK)
         {
-            logcon("[RMT] ERROR rmt_write_items failed");
+            FrameInProgress = false;
+            logcon("[RMT] ERROR rmt_write_sample failed");
             ok = false;
             break;
         }
 
-        rmt_wait_tx_done((rmt_channel_t)OutputRmtConfig.RmtChannelId, portMAX_DELAY);
-
-        if (SendFrameTaskHandle)
-            xTaskNotifyGive(SendFrameTaskHandle);
-
     } while (false);
 
     return ok;
@@ -285,7 +285,7 @@ void c_OutputSerial::StartNewFrame ()
     FrameStartCounter++;
 #endif // def USE_SERIAL_DEBUG_COUNTERS
 
-    NextIntensityToSend = GetBufferAddress();
+    NextIntensityToSend = LatchFrontBuffer();
     intensity_count     = Num_Channels;
     SentIntensityCount  = 0;
     SerialHeaderIndex   = 0;
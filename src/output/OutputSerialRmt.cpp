@@ -231,6 +231,11 @@ bool c_OutputSerialRmt::RmtPoll ()
             break;
         }
 
+        if (!canRefresh())
+        {
+            break;
+        }
+
         // DEBUG_V("get the next frame started");
         ReportNewFrame ();
         Response = Rmt.StartNewFrame ();
@@ -86,7 +86,7 @@ void c_OutputServoPCA9685::ClearBuffer ()
     // memset(GetBufferAddress(), 0x00, GetBufferUsedSize());
     for (ServoPCA9685Channel_t & currentServoPCA9685Channel : OutputList)
     {
-        GetBufferAddress()[currentServoPCA9685Channel.Id] =
+        pBackBuffer[currentServoPCA9685Channel.Id] =
             currentServoPCA9685Channel.HomeValue;
     }
 
@@ -128,7 +128,7 @@ void c_OutputSpi::Begin (c_OutputPixel* _OutputPixel)
     SpiBusConfiguration.sclk_io_num = ClockPin;
     SpiBusConfiguration.quadwp_io_num = -1;
     SpiBusConfiguration.quadhd_io_num = -1;
-    SpiBusConfiguration.max_transfer_sz = OM_MAX_NUM_CHANNELS;
+    SpiBusConfiguration.max_transfer_sz = OM_MAX_TOTAL_CHANNELS;
     SpiBusConfiguration.flags = SPICOMMON_BUSFLAG_MASTER;
 
     spi_device_interface_config_t SpiDeviceConfiguration;
@@ -278,6 +278,22 @@ void c_OutputSpi::SendIntensityData ()
                 digitalWrite(CsPin, HIGH);
             }
         }
+
+        if (!ISR_MoreDataToSend ())
+        {
+            // the last transaction for the frame has been queued
+            c_OutputCommon * pDataSource = OutputPixel;
+#if defined(SUPPORT_OutputType_GRINCH)
+            if (nullptr == pDataSource)
+            {
+                pDataSource = OutputGrinch;
+            }
+#endif // defined(SUPPORT_OutputType_GRINCH)
+            if (nullptr != pDataSource)
+            {
+                pDataSource->ReportFrameSent ();
+            }
+        }
     }
 
     // DEBUG_END;
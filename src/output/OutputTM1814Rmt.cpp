@@ -161,6 +161,11 @@ bool c_OutputTM1814Rmt::RmtPoll ()
             break;
         }
 
+        if (!canRefresh())
+        {
+            break;
+        }
+
         // DEBUG_V("get the next frame started");
         ReportNewFrame ();
         Response = Rmt.StartNewFrame ();
@@ -156,6 +156,11 @@ bool c_OutputUCS1903Rmt::RmtPoll ()
             break;
         }
 
+        if (!canRefresh())
+        {
+            break;
+        }
+
         // DEBUG_V("get the next frame started");
         ReportNewFrame ();
         Response = Rmt.StartNewFrame ();
@@ -51,6 +51,9 @@ extern "C"
 #   define UART_INV_MASK (0x3f << 19)
 #endif // ndef UART_INV_MASK
 
+// number of intensities fetched from the data source per call
+#define UART_INTENSITY_BATCH_SIZE   32
+
 // forward declaration for the isr handler
 static void IRAM_ATTR uart_intr_handler (void* param);
 #ifdef ARDUINO_ARCH_ESP8266
@@ -548,21 +551,24 @@ bool inline IRAM_ATTR c_OutputUart::MoreDataToSend()
 } // MoreDataToSend
 
 //----------------------------------------------------------------------------
-bool inline IRAM_ATTR c_OutputUart::GetNextIntensityToSend(uint32_t &DataToSend)
+uint32_t inline IRAM_ATTR c_OutputUart::GetNextIntensitiesToSend(uint32_t * pDataToSend, uint32_t MaxCount)
 {
     if (nullptr != OutputUartConfig.pPixelDataSource)
     {
-        return OutputUartConfig.pPixelDataSource->ISR_GetNextIntensityToSend(DataToSend);
+        return OutputUartConfig.pPixelDataSource->ISR_GetNextIntensitiesToSend(pDataToSend, MaxCount);
     }
     else
     {
+        uint32_t Count = 0;
 #if defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
-        return OutputUartConfig.pSerialDataSource->ISR_GetNextIntensityToSend(DataToSend);
-#else
-        return false;
+        while ((Count < MaxCount) && OutputUartConfig.pSerialDataSource->ISR_MoreDataToSend())
+        {
+            OutputUartConfig.pSerialDataSource->ISR_GetNextIntensityToSend(pDataToSend[Count++]);
+        }
 #endif // defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
+        return Count;
     }
-} // GetNextIntensityToSend
+} // GetNextIntensitiesToSend
 
 //----------------------------------------------------------------------------
 void IRAM_ATTR c_OutputUart::StartNewDataFrame()
@@ -749,6 +755,9 @@ void IRAM_ATTR c_OutputUart::ISR_Timer_Handler()
 //----------------------------------------------------------------------------
 void IRAM_ATTR c_OutputUart::ISR_Handler_SendIntensityData ()
 {
+    uint32_t IsrStartMicroSec = micros();
+    bool SentData = false;
+
     uint32_t NumAvailableIntensitySlotsToFill = ((((uint32_t)UART_TX_FIFO_SIZE) - (getUartFifoLength())) / NumUartSlotsPerIntensityValue);
 #ifdef USE_UART_DEBUG_COUNTERS
     if (NumAvailableIntensitySlotsToFill)
@@ -761,69 +770,81 @@ void IRAM_ATTR c_OutputUart::ISR_Handler_SendIntensityData ()
     }
 #endif // def USE_UART_DEBUG_COUNTERS
 
-    uint32_t IntensityValue;
-    bool MoreData = MoreDataToSend();
+    uint32_t IntensityValues[UART_INTENSITY_BATCH_SIZE];
 
-    while (MoreData && NumAvailableIntensitySlotsToFill)
+    while (NumAvailableIntensitySlotsToFill && MoreDataToSend())
     {
-#ifdef USE_UART_DEBUG_COUNTERS
-        IntensityValuesSent++;
-#endif // def USE_UART_DEBUG_COUNTERS
-
-        NumAvailableIntensitySlotsToFill--;
+        // inter intensity breaks are sent one intensity at a time
+        uint32_t NumIntensitiesToGet = (OutputUartConfig.NumInterIntensityBreakBits) ? 1 : min(NumAvailableIntensitySlotsToFill, uint32_t(UART_INTENSITY_BATCH_SIZE));
 
 #ifdef DEBUG_GPIO
         digitalWrite(DEBUG_GPIO, LOW);
 #endif // def DEBUG_GPIO
 
-        MoreData = GetNextIntensityToSend(IntensityValue);
+        uint32_t NumIntensities = GetNextIntensitiesToSend(IntensityValues, NumIntensitiesToGet);
 
 #ifdef DEBUG_GPIO
         digitalWrite(DEBUG_GPIO, HIGH);
 #endif // def DEBUG_GPIO
-        if (OutputUartConfig.TranslateIntensityData == TranslateIntensityData_t::NoTranslation)
+
+        if (0 == NumIntensities)
         {
-            for (uint32_t count = 0; count < NumUartSlotsPerIntensityValue; count++)
-            {
-                enqueueUartData(IntensityValue & 0xFF);
-                IntensityValue >>= 8;
+            break;
+        }
+        NumAvailableIntensitySlotsToFill -= NumIntensities;
+        SentData = true;
+
+        for (uint32_t IntensityIndex = 0; IntensityIndex < NumIntensities; ++IntensityIndex)
+        {
+            uint32_t IntensityValue = IntensityValues[IntensityIndex];
 #ifdef USE_UART_DEBUG_COUNTERS
-                IntensityBitsSent += 8;
+            IntensityValuesSent++;
 #endif // def USE_UART_DEBUG_COUNTERS
-            }
-        } // end no translation
 
-        else if (OutputUartConfig.TranslateIntensityData == TranslateIntensityData_t::OneToOne)
-        { // 1:1
-            for (uint32_t mask = TxIntensityDataStartingMask; 0 != mask; mask >>= 1)
+            if (OutputUartConfig.TranslateIntensityData == TranslateIntensityData_t::NoTranslation)
             {
-                // convert the intensity data into UART data
-                enqueueUartData(Intensity2Uart[(IntensityValue & mask) ? UartDataBitTranslationId_t::Uart_DATA_BIT_01_ID : UartDataBitTranslationId_t::Uart_DATA_BIT_00_ID]);
+                for (uint32_t count = 0; count < NumUartSlotsPerIntensityValue; count++)
+                {
+                    enqueueUartData(IntensityValue & 0xFF);
+                    IntensityValue >>= 8;
 #ifdef USE_UART_DEBUG_COUNTERS
-                IntensityBitsSent += 1;
+                    IntensityBitsSent += 8;
 #endif // def USE_UART_DEBUG_COUNTERS
-            }
-        } // end 1:1
+                }
+            } // end no translation
+
+            else if (OutputUartConfig.TranslateIntensityData == TranslateIntensityData_t::OneToOne)
+            { // 1:1
+                for (uint32_t mask = TxIntensityDataStartingMask; 0 != mask; mask >>= 1)
+                {
+                    // convert the intensity data into UART data
+                    enqueueUartData(Intensity2Uart[(IntensityValue & mask) ? UartDataBitTranslationId_t::Uart_DATA_BIT_01_ID : UartDataBitTranslationId_t::Uart_DATA_BIT_00_ID]);
+#ifdef USE_UART_DEBUG_COUNTERS
+                    IntensityBitsSent += 1;
+#endif // def USE_UART_DEBUG_COUNTERS
+                }
+            } // end 1:1
 
-        else // 2:1
-        {
-            // Mask is used as a shift counter that is decremented by 2.
-            for (uint32_t NumBitsToShift = TxIntensityDataStartingMask - 2;
-                 0 < NumBitsToShift;
-                 NumBitsToShift -= 2)
+            else // 2:1
             {
-                // convert the intensity data into UART data
-                enqueueUartData(Intensity2Uart[(IntensityValue >> NumBitsToShift) & 0x3]);
+                // Mask is used as a shift counter that is decremented by 2.
+                for (uint32_t NumBitsToShift = TxIntensityDataStartingMask - 2;
+                     0 < NumBitsToShift;
+                     NumBitsToShift -= 2)
+                {
+                    // convert the intensity data into UART data
+                    enqueueUartData(Intensity2Uart[(IntensityValue >> NumBitsToShift) & 0x3]);
 #ifdef USE_UART_DEBUG_COUNTERS
-                IntensityBitsSent += 2;
+                    IntensityBitsSent += 2;
 #endif // def USE_UART_DEBUG_COUNTERS
-            }
-            // handle the last two bits
-            enqueueUartData(Intensity2Uart[IntensityValue & 0x3]);
+                }
+                // handle the last two bits
+                enqueueUartData(Intensity2Uart[IntensityValue & 0x3]);
 #ifdef USE_UART_DEBUG_COUNTERS
-            IntensityBitsSent += 2;
+                IntensityBitsSent += 2;
 #endif    // def USE_UART_DEBUG_COUNTERS
-        } // end 2:1
+            } // end 2:1
+        }
 
         if (OutputUartConfig.NumInterIntensityBreakBits)
         {
@@ -832,6 +853,25 @@ void IRAM_ATTR c_OutputUart::ISR_Handler_SendIntensityData ()
         }
     } // end while there is space in the buffer
 
+    c_OutputCommon * pDataSource = OutputUartConfig.pPixelDataSource;
+#if defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
+    if (nullptr == pDataSource)
+    {
+        pDataSource = OutputUartConfig.pSerialDataSource;
+    }
+#endif // defined(SUPPORT_OutputType_DMX) || defined(SUPPORT_OutputType_Serial) || defined(SUPPORT_OutputType_Renard)
+
+    if (nullptr != pDataSource)
+    {
+        pDataSource->ReportIsrTime(micros() - IsrStartMicroSec);
+
+        // The last of the frame is now in the FIFO
+        if (SentData && !MoreDataToSend())
+        {
+            pDataSource->ReportFrameSent();
+        }
+    }
+
     // DEBUG_END;
 
 } // ISR_Handler_SendIntensityData
@@ -0,0 +1,141 @@
+/*
+* OutputWS2811I2s.cpp - WS2811 driver code for ESPixelStick I2S parallel lane
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2015, 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+#include "ESPixelStick.h"
+#if defined(SUPPORT_OutputType_WS2811) && defined(SUPPORT_I2S_OUTPUT)
+
+#include "output/OutputWS2811I2s.hpp"
+
+//----------------------------------------------------------------------------
+c_OutputWS2811I2s::c_OutputWS2811I2s (c_OutputMgr::e_OutputChannelIds OutputChannelId,
+    gpio_num_t outputGpio,
+    uart_port_t uart,
+    c_OutputMgr::e_OutputType outputType) :
+    c_OutputWS2811 (OutputChannelId, outputGpio, uart, outputType)
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+
+} // c_OutputWS2811I2s
+
+//----------------------------------------------------------------------------
+c_OutputWS2811I2s::~c_OutputWS2811I2s ()
+{
+    // DEBUG_START;
+
+    // the engine must stop pulling data from this driver before it goes away
+    OutputI2s.UnregisterLane (uint32_t (UartId));
+
+    // DEBUG_END;
+} // ~c_OutputWS2811I2s
+
+//----------------------------------------------------------------------------
+/* Use the current config to set up the output port
+*/
+void c_OutputWS2811I2s::Begin ()
+{
+    // DEBUG_START;
+
+    c_OutputWS2811::Begin ();
+
+    // DEBUG_V (String ("DataPin: ") + String (DataPin));
+
+    HasBeenInitialized = true;
+
+    // DEBUG_END;
+
+} // Begin
+
+//----------------------------------------------------------------------------
+bool c_OutputWS2811I2s::SetConfig (ArduinoJson::JsonObject& jsonConfig)
+{
+    // DEBUG_START;
+
+    bool response = c_OutputWS2811::SetConfig (jsonConfig);
+
+    // the lane id is carried in the port id. See OutputChannelIdToGpioAndPort
+    OutputI2s.RegisterLane (uint32_t (UartId), DataPin, InterFrameGapInMicroSec, this, this);
+
+    // DEBUG_END;
+    return response;
+
+} // SetConfig
+
+//----------------------------------------------------------------------------
+void c_OutputWS2811I2s::SetOutputBufferSize (uint32_t NumChannelsAvailable)
+{
+    // DEBUG_START;
+
+    c_OutputWS2811::SetOutputBufferSize (NumChannelsAvailable);
+
+    // DEBUG_END;
+
+} // SetBufferSize
+
+//----------------------------------------------------------------------------
+void c_OutputWS2811I2s::GetStatus (ArduinoJson::JsonObject& jsonStatus)
+{
+    // // DEBUG_START;
+    c_OutputWS2811::GetStatus (jsonStatus);
+    OutputI2s.GetStatus (jsonStatus);
+    // // DEBUG_END;
+} // GetStatus
+
+//----------------------------------------------------------------------------
+uint32_t c_OutputWS2811I2s::Poll ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+    return ActualFrameDurationMicroSec;
+
+} // Poll
+
+//----------------------------------------------------------------------------
+/* Called by the I2S engine when it is about to start a frame. Returns true
+*  if this lane has started its frame and should be sent.
+*/
+bool c_OutputWS2811I2s::I2sPoll ()
+{
+    // DEBUG_START;
+    bool Response = false;
+    do // Once
+    {
+        if (gpio_num_t(-1) == DataPin)
+        {
+            break;
+        }
+
+        if (Paused || !canRefresh())
+        {
+            break;
+        }
+
+        ReportNewFrame ();
+        StartNewFrame ();
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // I2sPoll
+
+#endif // defined(SUPPORT_OutputType_WS2811) && defined(SUPPORT_I2S_OUTPUT)
@@ -164,6 +164,11 @@ bool c_OutputWS2811Rmt::RmtPoll ()
             break;
         }
 
+        if (!canRefresh())
+        {
+            break;
+        }
+
         // DEBUG_V(String("get the next frame started on ") + String(DataPin));
         ReportNewFrame ();
         Response = Rmt.StartNewFrame ();
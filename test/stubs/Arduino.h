@@ -0,0 +1,178 @@
+#pragma once
+/*
+* Arduino.h - Minimal Arduino core for the native (host) unit tests
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Only what the driver code under test uses. The native env builds as an
+*   ESP8266 so the platform headers stay on their simplest path.
+*
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define F_CPU           80000000L
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define DEC             10
+#define HEX             16
+
+class __FlashStringHelper;
+#define F(s)            (reinterpret_cast<const __FlashStringHelper *>(s))
+#define FPSTR(p)        (reinterpret_cast<const __FlashStringHelper *>(p))
+#define PSTR(s)         (s)
+#define pgm_read_byte(addr)     (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr)     (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr)    (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_float(addr)    (*reinterpret_cast<const float *>(addr))
+#define pgm_read_ptr(addr)      (*reinterpret_cast<void * const *>(addr))
+#define strlen_P                strlen
+#define strcmp_P                strcmp
+#define strncmp_P               strncmp
+#define memcmp_P                memcmp
+#define memcpy_P                memcpy
+
+using std::min;
+using std::max;
+
+unsigned long millis ();
+unsigned long micros ();
+void delay (unsigned long ms);
+void delayMicroseconds (unsigned int us);
+void yield ();
+
+inline long map (long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline void pinMode (uint8_t, uint8_t) {}
+inline void digitalWrite (uint8_t, uint8_t) {}
+inline int  digitalRead (uint8_t) { return LOW; }
+
+class String
+{
+public:
+    String () {}
+    String (const char * s) { if (s) { Value = s; } }
+    String (const __FlashStringHelper * s) : String (reinterpret_cast<const char *>(s)) {}
+    String (const std::string & s) : Value (s) {}
+    String (const String & s) = default;
+    explicit String (char c) : Value (1, c) {}
+    explicit String (unsigned char v, unsigned char base = 10) { Format (false, v, base); }
+    explicit String (int v, unsigned char base = 10) { Format (v < 0, Magnitude (v), base); }
+    explicit String (unsigned int v, unsigned char base = 10) { Format (false, v, base); }
+    explicit String (long v, unsigned char base = 10) { Format (v < 0, Magnitude (v), base); }
+    explicit String (unsigned long v, unsigned char base = 10) { Format (false, v, base); }
+    explicit String (long long v, unsigned char base = 10) { Format (v < 0, Magnitude (v), base); }
+    explicit String (unsigned long long v, unsigned char base = 10) { Format (false, v, base); }
+    explicit String (float v, unsigned char decimals = 2) : String (double (v), decimals) {}
+    explicit String (double v, unsigned char decimals = 2)
+    {
+        char Buffer[64];
+        snprintf (Buffer, sizeof (Buffer), "%.*f", int (decimals), v);
+        Value = Buffer;
+    }
+
+    String & operator = (const String & s) = default;
+    String & operator = (const char * s) { if (s) { Value = s; } else { Value.clear (); } return *this; }
+    String & operator = (const __FlashStringHelper * s) { return *this = reinterpret_cast<const char *>(s); }
+
+    const char * c_str () const { return Value.c_str (); }
+    size_t length () const { return Value.length (); }
+    bool isEmpty () const { return Value.empty (); }
+    void reserve (size_t size) { Value.reserve (size); }
+
+    bool concat (const char * s) { if (s) { Value += s; } return true; }
+    bool concat (const String & s) { Value += s.Value; return true; }
+    bool concat (char c) { Value += c; return true; }
+    String & operator += (const String & s) { concat (s); return *this; }
+    String & operator += (const char * s) { concat (s); return *this; }
+    String & operator += (const __FlashStringHelper * s) { concat (reinterpret_cast<const char *>(s)); return *this; }
+    String & operator += (char c) { concat (c); return *this; }
+
+    bool equals (const String & s) const { return Value == s.Value; }
+    bool equalsIgnoreCase (const String & s) const { return strcasecmp (c_str (), s.c_str ()) == 0; }
+    bool operator == (const String & s) const { return Value == s.Value; }
+    bool operator == (const char * s) const { return Value == (s ? s : ""); }
+    bool operator != (const String & s) const { return Value != s.Value; }
+    bool operator != (const char * s) const { return !(*this == s); }
+    char operator [] (size_t index) const { return (index < Value.length ()) ? Value[index] : 0; }
+    char charAt (size_t index) const { return (*this)[index]; }
+
+    int indexOf (const String & s, size_t from = 0) const { return Found (Value.find (s.Value, from)); }
+    int indexOf (char c, size_t from = 0) const { return Found (Value.find (c, from)); }
+    int lastIndexOf (const String & s) const { return Found (Value.rfind (s.Value)); }
+    int lastIndexOf (char c) const { return Found (Value.rfind (c)); }
+    String substring (size_t from) const { return (from < Value.length ()) ? String (Value.substr (from)) : String (); }
+    String substring (size_t from, size_t to) const { return (from < to && from < Value.length ()) ? String (Value.substr (from, to - from)) : String (); }
+    void toLowerCase () { std::transform (Value.begin (), Value.end (), Value.begin (), ::tolower); }
+    void toUpperCase () { std::transform (Value.begin (), Value.end (), Value.begin (), ::toupper); }
+    void trim () { Value.erase (0, Value.find_first_not_of (" \t\r\n")); Value.erase (Value.find_last_not_of (" \t\r\n") + 1); }
+    long toInt () const { return atol (c_str ()); }
+    float toFloat () const { return float (atof (c_str ())); }
+
+private:
+    static uint64_t Magnitude (long long v) { return (v < 0) ? (0 - uint64_t (v)) : uint64_t (v); }
+    void Format (bool Negative, uint64_t v, unsigned char base)
+    {
+        do { Value.insert (Value.begin (), "0123456789abcdef"[v % base]); v /= base; } while (v);
+        if (Negative) { Value.insert (Value.begin (), '-'); }
+    }
+    static int Found (size_t pos) { return (std::string::npos == pos) ? -1 : int (pos); }
+
+    std::string Value;
+};
+
+class StringSumHelper : public String
+{
+public:
+    using String::String;
+};
+
+inline String operator + (const String & a, const String & b) { String r (a); r += b; return r; }
+inline String operator + (const String & a, const char * b) { String r (a); r += b; return r; }
+inline String operator + (const char * a, const String & b) { String r (a); r += b; return r; }
+inline String operator + (const String & a, const __FlashStringHelper * b) { String r (a); r += b; return r; }
+inline String operator + (const String & a, char b) { String r (a); r += b; return r; }
+
+class HardwareSerial
+{
+public:
+    void   begin (unsigned long) {}
+    size_t print (const String & s) { return s.length (); }
+    size_t println (const String & s = String ()) { return s.length () + 1; }
+    void   flush () {}
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,58 @@
+#pragma once
+/*
+* LittleFS.h - Flash file system stub for the native (host) unit tests
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include <Arduino.h>
+
+namespace fs
+{
+    enum SeekMode
+    {
+        SeekSet = 0,
+        SeekCur = 1,
+        SeekEnd = 2
+    };
+
+    class File
+    {
+    public:
+        size_t write (const uint8_t *, size_t) { return 0; }
+        size_t read (uint8_t *, size_t) { return 0; }
+        bool   seek (uint32_t, SeekMode = SeekSet) { return false; }
+        size_t size () const { return 0; }
+        void   close () {}
+        explicit operator bool () const { return false; }
+    };
+
+    class FS
+    {
+    public:
+        File open (const char *, const char *) { return File (); }
+        bool exists (const char *) { return false; }
+        bool remove (const char *) { return false; }
+    };
+} // namespace fs
+
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+extern fs::FS LittleFS;
@@ -0,0 +1,72 @@
+/*
+* NativeStubs.cpp - Platform and project stubs for the native (host) unit tests
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Stands in for the parts of the firmware that the drivers under test link
+*   against but do not exercise: the output manager driver factory, the input
+*   manager, the console and the file system.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "output/OutputMgr.hpp"
+#include "input/InputMgr.hpp"
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+fs::FS LittleFS;
+
+static const auto StartTime = std::chrono::steady_clock::now ();
+
+unsigned long millis ()
+{
+    return (unsigned long) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now () - StartTime).count ();
+}
+
+unsigned long micros ()
+{
+    // wraps at 32 bits like the target
+    return (unsigned long) uint32_t (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now () - StartTime).count ());
+}
+
+void delay (unsigned long ms) { std::this_thread::sleep_for (std::chrono::milliseconds (ms)); }
+void delayMicroseconds (unsigned int us) { std::this_thread::sleep_for (std::chrono::microseconds (us)); }
+void yield () {}
+
+bool ConsoleUartIsActive = false;
+void _logcon (String & , String ) {}
+void PrettyPrint (JsonDocument & , String ) {}
+void PrettyPrint (JsonArray & , String ) {}
+void PrettyPrint (JsonObject & , String ) {}
+
+c_FileMgr::c_FileMgr () {}
+c_FileMgr::~c_FileMgr () {}
+void c_FileMgr::DeleteFlashFile (String ) {}
+c_FileMgr FileMgr;
+
+c_OutputMgr::c_OutputMgr () {}
+c_OutputMgr::~c_OutputMgr () {}
+c_OutputMgr OutputMgr;
+
+FastTimer::FastTimer () {}
+FastTimer::~FastTimer () {}
+c_ExternalInput::c_ExternalInput () {}
+
+c_InputMgr::c_InputMgr () {}
+c_InputMgr::~c_InputMgr () {}
+void c_InputMgr::SetBufferInfo (uint32_t ) {}
+c_InputMgr InputMgr;
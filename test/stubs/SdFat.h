@@ -0,0 +1,44 @@
+#pragma once
+/*
+* SdFat.h - SD card library stub for the native (host) unit tests
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include <Arduino.h>
+
+#define SD_SCK_MHZ(m)   (uint32_t (m) * 1000000)
+
+class FsFile
+{
+public:
+    size_t write (const uint8_t *, size_t) { return 0; }
+    int    read (void *, size_t) { return 0; }
+    bool   seekSet (uint64_t) { return false; }
+    uint64_t size () const { return 0; }
+    bool   close () { return true; }
+    explicit operator bool () const { return false; }
+};
+
+typedef FsFile SdFile;
+
+class SdFat
+{
+public:
+    FsFile open (const char *, int = 0) { return FsFile (); }
+    bool   exists (const char *) { return false; }
+    bool   remove (const char *) { return false; }
+};
@@ -0,0 +1,34 @@
+#pragma once
+/*
+* Ticker.h - Ticker stub for the native (host) unit tests
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include <Arduino.h>
+
+class Ticker
+{
+public:
+    typedef std::function<void (void)> callback_function_t;
+
+    void attach (float, callback_function_t) {}
+    void attach_ms (uint32_t, callback_function_t) {}
+    void once (float, callback_function_t) {}
+    void once_ms (uint32_t, callback_function_t) {}
+    void detach () {}
+    bool active () const { return false; }
+};
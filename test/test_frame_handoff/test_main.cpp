@@ -0,0 +1,224 @@
+/*
+* test_main.cpp - Host tests for the double buffer frame handoff
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Run with: pio test -e native -f test_frame_handoff
+*
+*   The stress test runs the inputs and the outputs on their own threads.
+*   Every word of a frame carries the frame sequence number, so a bank that
+*   the inputs write into while it is being sent shows up as a frame with
+*   more than one sequence number in it.
+*
+*/
+
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "output/OutputFrameHandoff.hpp"
+
+#define TEST_FRAME_WORDS    512
+#define TEST_NUM_FRAMES     20000   // frames sent by the outputs
+
+static c_FrameHandoff         Handoff;
+static std::vector<uint32_t>  Banks[FRAME_HANDOFF_NUM_BANKS];
+
+//----------------------------------------------------------------------------
+void setUp ()
+{
+    Handoff.Reset (true);
+    for (std::vector<uint32_t> & Bank : Banks)
+    {
+        Bank.assign (TEST_FRAME_WORDS, 0);
+    }
+}
+
+void tearDown () {}
+
+//----------------------------------------------------------------------------
+static void WriteFrame (uint32_t Sequence)
+{
+    std::vector<uint32_t> & Bank = Banks[Handoff.GetBackBank ()];
+    for (uint32_t & Word : Bank)
+    {
+        Word = Sequence;
+    }
+}
+
+//----------------------------------------------------------------------------
+void test_publish_and_take ()
+{
+    TEST_ASSERT_FALSE (Handoff.Take ());
+
+    WriteFrame (1);
+    uint32_t Published = Handoff.Publish ();
+    TEST_ASSERT_TRUE (Handoff.Take ());
+    TEST_ASSERT_EQUAL_UINT32 (Published, Handoff.GetFrontBank ());
+    TEST_ASSERT_EQUAL_UINT32 (1, Handoff.GetFrontSequence ());
+    TEST_ASSERT_FALSE (Handoff.Take ());
+
+    // the second frame replaces the third before the outputs get to it
+    WriteFrame (2);
+    Handoff.Publish ();
+    WriteFrame (3);
+    Handoff.Publish ();
+    TEST_ASSERT_TRUE (Handoff.Take ());
+    TEST_ASSERT_EQUAL_UINT32 (3, Handoff.GetFrontSequence ());
+    TEST_ASSERT_EQUAL_UINT32 (1, Handoff.GetDroppedFrames ());
+    TEST_ASSERT_EQUAL_UINT32 (3, Banks[Handoff.GetFrontBank ()][0]);
+}
+
+//----------------------------------------------------------------------------
+void test_latched_bank_is_not_reused ()
+{
+    WriteFrame (1);
+    Handoff.Publish ();
+    TEST_ASSERT_TRUE (Handoff.Take ());
+
+    // a driver starts sending frame 1 and the outputs move on to frame 2
+    uint32_t Sending = Handoff.Latch ();
+    WriteFrame (2);
+    Handoff.Publish ();
+    TEST_ASSERT_TRUE (Handoff.Take ());
+
+    // the inputs keep publishing. Frame 1 must never come back to them
+    for (uint32_t Sequence = 3; Sequence < 20; ++Sequence)
+    {
+        TEST_ASSERT_TRUE (Sending != Handoff.GetBackBank ());
+        WriteFrame (Sequence);
+        TEST_ASSERT_TRUE (Sending != Handoff.Publish ());
+        TEST_ASSERT_FALSE (Handoff.Take ());
+    }
+    TEST_ASSERT_EQUAL_UINT32 (1, Banks[Sending][0]);
+    TEST_ASSERT_TRUE (0 != Handoff.GetDeferredTakes ());
+
+    // once the driver is done the latest frame goes out
+    Handoff.Release (Sending);
+    TEST_ASSERT_TRUE (Handoff.Take ());
+    TEST_ASSERT_EQUAL_UINT32 (19, Handoff.GetFrontSequence ());
+}
+
+//----------------------------------------------------------------------------
+void test_single_buffered ()
+{
+    Handoff.Reset (false);
+    TEST_ASSERT_EQUAL_UINT32 (0, Handoff.GetFrontBank ());
+    TEST_ASSERT_EQUAL_UINT32 (0, Handoff.GetBackBank ());
+    TEST_ASSERT_EQUAL_UINT32 (0, Handoff.Latch ());
+    Handoff.Release (0);
+    Handoff.Release (FRAME_HANDOFF_NO_BANK);
+}
+
+//----------------------------------------------------------------------------
+static std::atomic<uint32_t> FramesPublished {0};
+
+static void WaitForNewFrames (uint32_t Count)
+{
+    uint32_t Target = FramesPublished + Count;
+    while (FramesPublished < Target)
+    {
+        std::this_thread::yield ();
+    }
+}
+
+//----------------------------------------------------------------------------
+/*
+*   The output thread does what Poll and a driver ISR do between them. It
+*   takes a frame, latches it and starts sending it. Part way through the
+*   frame it polls for new frames while the inputs keep publishing, which
+*   is where a bank that is still on the wire would be handed back to the
+*   inputs. Waiting for the inputs at those points forces the interleaving
+*   even on a single core.
+*/
+void test_stress_two_threads ()
+{
+    std::atomic<bool> Done {false};
+    uint32_t TornFrames     = 0;
+    uint32_t OutOfOrder     = 0;
+    uint32_t FramesSent     = 0;
+    uint32_t LastSequence   = 0;
+
+    std::thread Inputs ([&Done]
+    {
+        uint32_t Sequence = 0;
+        while (!Done)
+        {
+            WriteFrame (++Sequence);
+            Handoff.Publish ();
+            ++FramesPublished;
+            std::this_thread::yield ();
+        }
+    });
+
+    std::thread Outputs ([&]
+    {
+        while (FramesSent < TEST_NUM_FRAMES)
+        {
+            Handoff.Take ();
+            uint32_t Bank = Handoff.Latch ();
+            const std::vector<uint32_t> & Frame = Banks[Bank];
+
+            uint32_t Sequence = Frame[0];
+            bool     Torn     = false;
+            for (uint32_t Index = 0; Index < TEST_FRAME_WORDS / 2; ++Index)
+            {
+                Torn |= (Frame[Index] != Sequence);
+            }
+
+            // the first poll retires this bank, the second must not give it back
+            WaitForNewFrames (1);
+            Handoff.Take ();
+            WaitForNewFrames (2);
+            Handoff.Take ();
+            WaitForNewFrames (2);
+
+            for (uint32_t Index = TEST_FRAME_WORDS / 2; Index < TEST_FRAME_WORDS; ++Index)
+            {
+                Torn |= (Frame[Index] != Sequence);
+            }
+            Handoff.Release (Bank);
+
+            TornFrames += Torn ? 1 : 0;
+            OutOfOrder += (Sequence < LastSequence) ? 1 : 0;
+            LastSequence = Sequence;
+            ++FramesSent;
+        }
+        Done = true;
+    });
+
+    Inputs.join ();
+    Outputs.join ();
+
+    char Message[128];
+    snprintf (Message, sizeof (Message), "Frames sent: %u, dropped: %u, deferred takes: %u",
+              unsigned (FramesSent), unsigned (Handoff.GetDroppedFrames ()), unsigned (Handoff.GetDeferredTakes ()));
+    TEST_MESSAGE (Message);
+
+    TEST_ASSERT_EQUAL_UINT32 (0, TornFrames);
+    TEST_ASSERT_EQUAL_UINT32 (0, OutOfOrder);
+    TEST_ASSERT_TRUE (0 != Handoff.GetDeferredTakes ());
+}
+
+//----------------------------------------------------------------------------
+int main (int, char **)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_publish_and_take);
+    RUN_TEST (test_latched_bank_is_not_reused);
+    RUN_TEST (test_single_buffered);
+    RUN_TEST (test_stress_two_threads);
+    return UNITY_END ();
+}
@@ -0,0 +1,125 @@
+/*
+* test_main.cpp - Golden vectors for the I2S parallel output encoder
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Run with: pio test -e native -f test_i2s_encoder
+*
+*/
+
+#include <unity.h>
+#include "output/OutputI2sEncoder.hpp"
+
+// the same sixteen lanes are used by the encoder cases
+static const uint8_t LaneBytes[I2S_MAX_LANES] =
+{
+    0xa5, 0x3c, 0x0f, 0xf0, 0x55, 0xaa, 0x81, 0x7e,
+    0x01, 0x80, 0xff, 0x00, 0x12, 0x34, 0x56, 0x78,
+};
+
+//----------------------------------------------------------------------------
+void setUp () {}
+void tearDown () {}
+
+//----------------------------------------------------------------------------
+void test_transpose_diagonal ()
+{
+    // lane i only has bit (7 - i) set, so row i only has lane i set
+    const uint8_t Lanes[8]    = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    const uint8_t Expected[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+    uint8_t Rows[8];
+
+    I2sTranspose8 (Lanes, Rows);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (Expected, Rows, 8);
+}
+
+//----------------------------------------------------------------------------
+void test_transpose_mixed ()
+{
+    const uint8_t Expected[8] = { 0x69, 0x98, 0xab, 0x9a, 0xa6, 0x97, 0xa4, 0x55 };
+    uint8_t Rows[8];
+
+    I2sTranspose8 (LaneBytes, Rows);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (Expected, Rows, 8);
+}
+
+//----------------------------------------------------------------------------
+void test_encode_one_lane ()
+{
+    // 0x80 on lane 0: a one bit (1 1 1 0) then seven zero bits (1 0 0 0)
+    const uint8_t  Lanes[I2S_MAX_LANES] = { 0x80 };
+    const uint16_t Expected[I2S_WORDS_PER_INTENSITY] =
+    {
+        1, 1, 1, 0,  1, 0, 0, 0,  1, 0, 0, 0,  1, 0, 0, 0,
+        1, 0, 0, 0,  1, 0, 0, 0,  1, 0, 0, 0,  1, 0, 0, 0,
+    };
+    uint16_t Words[I2S_WORDS_PER_INTENSITY];
+
+    I2sEncodeWS2811 (Lanes, 0x0001, Words, false);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY (Expected, Words, I2S_WORDS_PER_INTENSITY);
+}
+
+//----------------------------------------------------------------------------
+void test_encode_all_lanes ()
+{
+    const uint16_t Expected[I2S_WORDS_PER_INTENSITY] =
+    {
+        0xffff, 0x0669, 0x0669, 0x0000,
+        0xffff, 0xc498, 0xc498, 0x0000,
+        0xffff, 0xa4ab, 0xa4ab, 0x0000,
+        0xffff, 0xf49a, 0xf49a, 0x0000,
+        0xffff, 0x84a6, 0x84a6, 0x0000,
+        0xffff, 0x6497, 0x6497, 0x0000,
+        0xffff, 0x54a4, 0x54a4, 0x0000,
+        0xffff, 0x0555, 0x0555, 0x0000,
+    };
+    uint16_t Words[I2S_WORDS_PER_INTENSITY];
+
+    I2sEncodeWS2811 (LaneBytes, 0xffff, Words, false);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY (Expected, Words, I2S_WORDS_PER_INTENSITY);
+}
+
+//----------------------------------------------------------------------------
+void test_encode_inactive_lanes_swapped ()
+{
+    // lanes 8 - 15 stay low and each pair of words is stored swapped
+    const uint16_t Expected[I2S_WORDS_PER_INTENSITY] =
+    {
+        0x0069, 0x00ff, 0x0000, 0x0069,
+        0x0098, 0x00ff, 0x0000, 0x0098,
+        0x00ab, 0x00ff, 0x0000, 0x00ab,
+        0x009a, 0x00ff, 0x0000, 0x009a,
+        0x00a6, 0x00ff, 0x0000, 0x00a6,
+        0x0097, 0x00ff, 0x0000, 0x0097,
+        0x00a4, 0x00ff, 0x0000, 0x00a4,
+        0x0055, 0x00ff, 0x0000, 0x0055,
+    };
+    uint16_t Words[I2S_WORDS_PER_INTENSITY];
+
+    I2sEncodeWS2811 (LaneBytes, 0x00ff, Words, true);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY (Expected, Words, I2S_WORDS_PER_INTENSITY);
+}
+
+//----------------------------------------------------------------------------
+int main (int, char **)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_transpose_diagonal);
+    RUN_TEST (test_transpose_mixed);
+    RUN_TEST (test_encode_one_lane);
+    RUN_TEST (test_encode_all_lanes);
+    RUN_TEST (test_encode_inactive_lanes_swapped);
+    return UNITY_END ();
+}
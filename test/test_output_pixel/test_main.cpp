@@ -0,0 +1,277 @@
+/*
+* test_main.cpp - Host tests for the pixel buffer mapping and send path
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Run with: pio test -e native -f test_output_pixel
+*
+*   Each case writes input channels through WriteChannelData and checks the
+*   intensities the driver hands to the ISR against a known frame. Gamma is
+*   1.0 and brightness is 100% so the intensities are not altered.
+*
+*/
+
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "ESPixelStick.h"
+#include "output/OutputPixel.hpp"
+
+//----------------------------------------------------------------------------
+class c_TestPixel : public c_OutputPixel
+{
+public:
+    c_TestPixel () :
+        c_OutputPixel (c_OutputMgr::e_OutputChannelIds (0),
+                       gpio_num_t (-1),
+                       uart_port_t (-1),
+                       c_OutputMgr::e_OutputType::OutputType_WS2811) {}
+
+    uint32_t Poll () { return 0; }
+    void     GetDriverName (String & Name) { Name = "TestPixel"; }
+
+    void Configure (JsonObject & jsonConfig)
+    {
+        SetConfig (jsonConfig);
+
+        uint32_t BufferSize = max (GetNumOutputBufferBytesNeeded (), GetNumOutputBufferChannelsServiced ());
+        Buffer.assign (BufferSize, 0);
+        SetOutputBufferAddress (Buffer.data ());
+        SetOutputBufferSize (BufferSize);
+    }
+
+    std::vector<uint32_t> SendFrame ()
+    {
+        std::vector<uint32_t> Sent;
+        uint32_t Intensity;
+
+        StartNewFrame ();
+        while (ISR_MoreDataToSend ())
+        {
+            ISR_GetNextIntensityToSend (Intensity);
+            Sent.push_back (Intensity);
+        }
+        return Sent;
+    }
+
+    std::vector<uint8_t> Buffer;
+};
+
+//----------------------------------------------------------------------------
+static void ConfigurePixels (c_TestPixel & Pixels,
+                             uint32_t PixelCount,
+                             const char * ColorOrder,
+                             uint32_t ZigSize = 1,
+                             uint32_t GroupSize = 1,
+                             uint32_t PrependNulls = 0,
+                             uint32_t AppendNulls = 0,
+                             bool Input16Bit = false)
+{
+    JsonDocument ConfigDoc;
+    JsonObject jsonConfig = ConfigDoc.to<JsonObject> ();
+
+    JsonWrite (jsonConfig, CN_color_order,      ColorOrder);
+    JsonWrite (jsonConfig, CN_pixel_count,      PixelCount);
+    JsonWrite (jsonConfig, CN_group_size,       GroupSize);
+    JsonWrite (jsonConfig, CN_zig_size,         ZigSize);
+    JsonWrite (jsonConfig, CN_gamma,            1.0);
+    JsonWrite (jsonConfig, CN_brightness,       100);
+    JsonWrite (jsonConfig, CN_prependnullcount, PrependNulls);
+    JsonWrite (jsonConfig, CN_appendnullcount,  AppendNulls);
+    JsonWrite (jsonConfig, CN_input_16bit,      Input16Bit);
+
+    Pixels.Configure (jsonConfig);
+}
+
+//----------------------------------------------------------------------------
+static void CheckFrame (c_TestPixel & Pixels, const std::vector<uint32_t> & Expected)
+{
+    std::vector<uint32_t> Sent = Pixels.SendFrame ();
+
+    TEST_ASSERT_EQUAL_UINT32 (Expected.size (), Sent.size ());
+    TEST_ASSERT_EQUAL_UINT32_ARRAY (Expected.data (), Sent.data (), Expected.size ());
+}
+
+//----------------------------------------------------------------------------
+void setUp () {}
+void tearDown () {}
+
+//----------------------------------------------------------------------------
+void test_color_order ()
+{
+    c_TestPixel Pixels;
+    ConfigurePixels (Pixels, 2, "grb");
+
+    uint8_t Input[] = { 1, 2, 3,  4, 5, 6 };
+    Pixels.WriteChannelData (0, sizeof (Input), Input);
+
+    CheckFrame (Pixels, { 2, 1, 3,  5, 4, 6 });
+}
+
+//----------------------------------------------------------------------------
+void test_zig_zag ()
+{
+    c_TestPixel Pixels;
+    ConfigurePixels (Pixels, 6, "rgb", 2);
+
+    uint8_t Input[] = { 11, 12, 13,  21, 22, 23,  31, 32, 33,  41, 42, 43,  51, 52, 53,  61, 62, 63 };
+    Pixels.WriteChannelData (0, sizeof (Input), Input);
+
+    // every other group of two pixels runs backwards
+    CheckFrame (Pixels, { 11, 12, 13,  21, 22, 23,  41, 42, 43,  31, 32, 33,  51, 52, 53,  61, 62, 63 });
+}
+
+//----------------------------------------------------------------------------
+void test_grouping ()
+{
+    c_TestPixel Pixels;
+    ConfigurePixels (Pixels, 6, "rgb", 1, 3);
+
+    // two input pixels, each drives three physical pixels
+    uint8_t Input[] = { 1, 2, 3,  4, 5, 6 };
+    Pixels.WriteChannelData (0, sizeof (Input), Input);
+
+    CheckFrame (Pixels, { 1, 2, 3,  1, 2, 3,  1, 2, 3,  4, 5, 6,  4, 5, 6,  4, 5, 6 });
+}
+
+//----------------------------------------------------------------------------
+void test_null_pixels ()
+{
+    c_TestPixel Pixels;
+    ConfigurePixels (Pixels, 2, "rgb", 1, 1, 2, 1);
+
+    uint8_t Input[] = { 1, 2, 3,  4, 5, 6 };
+    Pixels.WriteChannelData (0, sizeof (Input), Input);
+
+    CheckFrame (Pixels, { 0, 0, 0,  0, 0, 0,  1, 2, 3,  4, 5, 6,  0, 0, 0 });
+}
+
+//----------------------------------------------------------------------------
+void test_split_16_bit_write ()
+{
+    c_TestPixel Pixels;
+    Pixels.SetIntensityDataWidth (16);
+    ConfigurePixels (Pixels, 2, "rgb", 1, 1, 0, 0, true);
+
+    // high / low pairs. The first write ends in the middle of the green pair
+    uint8_t Input[] = { 0x10, 0xff,  0x20, 0x80,  0x30, 0x00,  0x40, 0x01,  0x50, 0x7f,  0x60, 0xfe };
+    Pixels.WriteChannelData (0, 3, &Input[0]);
+    Pixels.WriteChannelData (3, sizeof (Input) - 3, &Input[3]);
+    CheckFrame (Pixels, { 0x10ff, 0x2080, 0x3000,  0x4001, 0x507f, 0x60fe });
+
+    // the same frame in one write
+    Pixels.ClearBuffer ();
+    Pixels.WriteChannelData (0, sizeof (Input), Input);
+    CheckFrame (Pixels, { 0x10ff, 0x2080, 0x3000,  0x4001, 0x507f, 0x60fe });
+}
+
+//----------------------------------------------------------------------------
+void test_segments_out_of_range ()
+{
+    // each of these would wrap the map size or run past the last channel
+    const uint32_t BadSegments[][2] =
+    {
+        { 0xfffffffd,                    2 },
+        { 3,                             0x55555556 },
+        { OM_MAX_TOTAL_CHANNELS - 3,     2 },
+    };
+
+    for (const uint32_t * BadSegment : BadSegments)
+    {
+        c_TestPixel Pixels;
+
+        JsonDocument ConfigDoc;
+        JsonObject jsonConfig = ConfigDoc.to<JsonObject> ();
+
+        JsonWrite (jsonConfig, CN_color_order, "rgb");
+        JsonWrite (jsonConfig, CN_pixel_count, 2);
+        JsonWrite (jsonConfig, CN_gamma,       1.0);
+        JsonWrite (jsonConfig, CN_brightness,  100);
+
+        // the second pixel is sent backwards by a segment that fits
+        JsonArray JsonSegmentList = jsonConfig[(char*)CN_segments].to<JsonArray> ();
+        JsonObject GoodSegmentData = JsonSegmentList.add<JsonObject> ();
+        JsonWrite (GoodSegmentData, CN_start_channel, 0);
+        JsonWrite (GoodSegmentData, CN_count,         2);
+        JsonWrite (GoodSegmentData, CN_reverse,       true);
+        JsonObject BadSegmentData = JsonSegmentList.add<JsonObject> ();
+        JsonWrite (BadSegmentData, CN_start_channel, BadSegment[0]);
+        JsonWrite (BadSegmentData, CN_count,         BadSegment[1]);
+
+        Pixels.Configure (jsonConfig);
+        TEST_ASSERT_EQUAL_UINT32 (6, Pixels.GetNumOutputBufferChannelsServiced ());
+
+        uint8_t Input[] = { 1, 2, 3,  4, 5, 6 };
+        Pixels.WriteChannelData (0, sizeof (Input), Input);
+        CheckFrame (Pixels, { 4, 5, 6,  1, 2, 3 });
+    }
+}
+
+//----------------------------------------------------------------------------
+void test_benchmark_ns_per_channel ()
+{
+#define BENCHMARK_PIXELS     1200
+#define BENCHMARK_FRAMES     200
+    c_TestPixel Pixels;
+    ConfigurePixels (Pixels, BENCHMARK_PIXELS, "grb", 4);
+
+    std::vector<uint8_t>  Input (BENCHMARK_PIXELS * 3);
+    std::vector<uint32_t> Intensities (BENCHMARK_PIXELS * 3);
+    for (uint32_t Index = 0; Index < Input.size (); ++Index)
+    {
+        Input[Index] = uint8_t (Index);
+    }
+
+    uint32_t Sent = 0;
+    auto WriteStart = std::chrono::steady_clock::now ();
+    for (uint32_t Frame = 0; Frame < BENCHMARK_FRAMES; ++Frame)
+    {
+        Pixels.WriteChannelData (0, Input.size (), Input.data ());
+    }
+    auto SendStart = std::chrono::steady_clock::now ();
+    for (uint32_t Frame = 0; Frame < BENCHMARK_FRAMES; ++Frame)
+    {
+        Pixels.StartNewFrame ();
+        while (Pixels.ISR_MoreDataToSend ())
+        {
+            Sent += Pixels.ISR_GetNextIntensitiesToSend (Intensities.data (), Intensities.size ());
+        }
+    }
+    auto End = std::chrono::steady_clock::now ();
+
+    TEST_ASSERT_EQUAL_UINT32 (Input.size () * BENCHMARK_FRAMES, Sent);
+
+    double Channels = double (Input.size ()) * BENCHMARK_FRAMES;
+    double WriteNs  = std::chrono::duration<double, std::nano> (SendStart - WriteStart).count () / Channels;
+    double SendNs   = std::chrono::duration<double, std::nano> (End - SendStart).count () / Channels;
+
+    char Message[128];
+    snprintf (Message, sizeof (Message), "WriteChannelData: %.2f ns/channel, ISR_GetNextIntensitiesToSend: %.2f ns/channel", WriteNs, SendNs);
+    TEST_MESSAGE (Message);
+} // test_benchmark_ns_per_channel
+
+//----------------------------------------------------------------------------
+int main (int, char **)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_color_order);
+    RUN_TEST (test_zig_zag);
+    RUN_TEST (test_grouping);
+    RUN_TEST (test_null_pixels);
+    RUN_TEST (test_split_16_bit_write);
+    RUN_TEST (test_segments_out_of_range);
+    RUN_TEST (test_benchmark_ns_per_channel);
+    return UNITY_END ();
+}
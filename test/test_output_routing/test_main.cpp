@@ -0,0 +1,242 @@
+/*
+* test_main.cpp - Host tests for the output manager channel routing
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Run with: pio test -e native -f test_output_routing
+*
+*   The native build has two output ports. The first gets a serial output and
+*   the second a pixel output. Each case writes one block of input channels
+*   that spans both outputs through c_OutputMgr::WriteChannelData and checks
+*   the data the drivers send from against a known frame. Gamma is 1.0 and
+*   brightness is 100% so the intensities are not altered.
+*
+*/
+
+#include <unity.h>
+#include <new>
+#include <vector>
+#include "ESPixelStick.h"
+#include "output/OutputMgr.hpp"
+#include "output/OutputPixel.hpp"
+#include "output/OutputSerial.hpp"
+
+static_assert (2 == c_OutputMgr::OutputChannelId_End, "the native build has two output ports");
+
+//----------------------------------------------------------------------------
+class c_TestSerial : public c_OutputSerial
+{
+public:
+    c_TestSerial () :
+        c_OutputSerial (c_OutputMgr::e_OutputChannelIds (0),
+                        gpio_num_t (-1),
+                        uart_port_t (-1),
+                        c_OutputMgr::e_OutputType::OutputType_Serial) {}
+
+    uint32_t Poll () { return 0; }
+};
+
+//----------------------------------------------------------------------------
+class c_TestPixel : public c_OutputPixel
+{
+public:
+    c_TestPixel () :
+        c_OutputPixel (c_OutputMgr::e_OutputChannelIds (1),
+                       gpio_num_t (-1),
+                       uart_port_t (-1),
+                       c_OutputMgr::e_OutputType::OutputType_WS2811) {}
+
+    uint32_t Poll () { return 0; }
+    void     GetDriverName (String & Name) { Name = "TestPixel"; }
+};
+
+//----------------------------------------------------------------------------
+/*
+*   Does what the driver factory and ProcessJsonConfig do for the two ports
+*   without any of the hardware drivers.
+*/
+class c_OutputMgrTest
+{
+public:
+    static void Begin (uint32_t NumSerialChannels, uint32_t NumPixels, const char * ColorOrder, bool DoubleBuffer)
+    {
+        JsonDocument ConfigDoc;
+
+        c_OutputMgr::DriverInfo_t & SerialOutput = OutputMgr.OutputChannelDrivers[0];
+        c_TestSerial * pSerial = new (&SerialOutput.OutputDriver) c_TestSerial ();
+        SerialOutput.OutputDriverInUse = true;
+        SerialOutput.PortType          = c_OutputMgr::OM_PortType_t::Uart;
+
+        JsonObject SerialConfig = ConfigDoc[(char*)CN_Serial].to<JsonObject> ();
+        JsonWrite (SerialConfig, CN_num_chan, NumSerialChannels);
+        pSerial->SetConfig (SerialConfig);
+
+        c_OutputMgr::DriverInfo_t & PixelOutput = OutputMgr.OutputChannelDrivers[1];
+        c_TestPixel * pPixels = new (&PixelOutput.OutputDriver) c_TestPixel ();
+        PixelOutput.OutputDriverInUse = true;
+        PixelOutput.PortType          = c_OutputMgr::OM_PortType_t::Uart;
+
+        JsonObject PixelConfig = ConfigDoc[(char*)CN_WS2811].to<JsonObject> ();
+        JsonWrite (PixelConfig, CN_color_order, ColorOrder);
+        JsonWrite (PixelConfig, CN_pixel_count, NumPixels);
+        JsonWrite (PixelConfig, CN_gamma,       1.0);
+        JsonWrite (PixelConfig, CN_brightness,  100);
+        pPixels->SetConfig (PixelConfig);
+
+        OutputMgr.DoubleBufferEnabled = DoubleBuffer;
+        OutputMgr.UpdateDoubleBuffer ();
+        OutputMgr.UpdateDisplayBufferReferences ();
+    }
+
+    static void End ()
+    {
+        OutputMgr.DoubleBufferEnabled = false;
+        OutputMgr.UpdateDoubleBuffer ();
+        OutputMgr.UpdateOverflowBuffer (0, false);
+
+        for (c_OutputMgr::DriverInfo_t & CurrentOutput : OutputMgr.OutputChannelDrivers)
+        {
+            if (CurrentOutput.OutputDriverInUse)
+            {
+                ((c_OutputCommon*)CurrentOutput.OutputDriver)->~c_OutputCommon ();
+                CurrentOutput = c_OutputMgr::DriverInfo_t ();
+            }
+        }
+
+        memset (OutputMgr.OutputBuffer, 0x00, sizeof (OutputMgr.OutputBuffer));
+    }
+
+    static bool     IdentityMapped (uint32_t Port)   { return OutputMgr.OutputChannelDrivers[Port].IdentityMapped; }
+    static bool     InOverflowBuffer (uint32_t Port) { return OutputMgr.OutputChannelDrivers[Port].InOverflowBuffer; }
+    static uint8_t* InternalBuffer ()                { return OutputMgr.OutputBuffer; }
+    static bool     TakeFrame ()                     { return OutputMgr.TakeFrame (); }
+};
+
+//----------------------------------------------------------------------------
+// what the drivers send from, in ReadOutputBuffer order
+static std::vector<uint8_t> SentData (uint32_t Offset, uint32_t Count)
+{
+    std::vector<uint8_t> Data (Count, 0xee);
+    TEST_ASSERT_EQUAL_UINT32 (Count, OutputMgr.ReadOutputBuffer (Offset, Count, Data.data ()));
+    return Data;
+}
+
+//----------------------------------------------------------------------------
+void setUp () {}
+void tearDown () { c_OutputMgrTest::End (); }
+
+//----------------------------------------------------------------------------
+void test_identity_routing ()
+{
+    c_OutputMgrTest::Begin (8, 4, "rgb", false);
+    TEST_ASSERT_EQUAL_UINT32 (8 + 12, OutputMgr.GetBufferUsedSize ());
+    TEST_ASSERT_TRUE (c_OutputMgrTest::IdentityMapped (0));
+    TEST_ASSERT_TRUE (c_OutputMgrTest::IdentityMapped (1));
+
+    // the last four serial channels and the first eight pixel channels
+    uint8_t Input[] = { 101, 102, 103, 104,  105, 106, 107, 108, 109, 110, 111, 112 };
+    OutputMgr.WriteChannelData (4, sizeof (Input), Input);
+
+    const uint8_t Expected[] =
+    {
+        0, 0, 0, 0, 101, 102, 103, 104,
+        105, 106, 107,  108, 109, 110,  111, 112, 0,  0, 0, 0,
+    };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Expected, SentData (0, sizeof (Expected)).data (), sizeof (Expected));
+}
+
+//----------------------------------------------------------------------------
+void test_overflow_routing ()
+{
+    // the pixels do not fit in the internal buffer behind the serial output
+    c_OutputMgrTest::Begin (512, 1100, "grb", false);
+    TEST_ASSERT_EQUAL_UINT32 (512 + 3300, OutputMgr.GetBufferUsedSize ());
+    TEST_ASSERT_TRUE (c_OutputMgrTest::IdentityMapped (0));
+    TEST_ASSERT_FALSE (c_OutputMgrTest::InOverflowBuffer (0));
+    TEST_ASSERT_FALSE (c_OutputMgrTest::IdentityMapped (1));
+    TEST_ASSERT_TRUE (c_OutputMgrTest::InOverflowBuffer (1));
+
+    uint8_t Input[] = { 1, 2, 3, 4,  5, 6, 7,  8, 9, 10,  11, 12 };
+    OutputMgr.WriteChannelData (508, sizeof (Input), Input);
+
+    // the pixel channels are sent in green, red, blue order
+    const uint8_t Expected[] = { 1, 2, 3, 4,  6, 5, 7,  9, 8, 10,  12, 11, 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Expected, SentData (508, sizeof (Expected)).data (), sizeof (Expected));
+
+    // nothing lands in the internal buffer past the serial output
+    const uint8_t Untouched[16] = { 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Untouched, &c_OutputMgrTest::InternalBuffer ()[512], sizeof (Untouched));
+}
+
+//----------------------------------------------------------------------------
+void test_double_buffered_overflow_routing ()
+{
+    c_OutputMgrTest::Begin (512, 1100, "grb", true);
+    TEST_ASSERT_TRUE (c_OutputMgrTest::InOverflowBuffer (1));
+    TEST_ASSERT_TRUE (OutputMgr.FramesAreStaged ());
+
+    uint8_t Input[] = { 1, 2, 3, 4,  5, 6, 7,  8, 9, 10,  11, 12 };
+    OutputMgr.WriteChannelData (508, sizeof (Input), Input);
+
+    // nothing is sent until the frame is committed and taken by the outputs
+    const uint8_t Idle[13] = { 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Idle, SentData (508, sizeof (Idle)).data (), sizeof (Idle));
+
+    OutputMgr.CommitFrame ();
+    TEST_ASSERT_TRUE (c_OutputMgrTest::TakeFrame ());
+
+    const uint8_t Expected[] = { 1, 2, 3, 4,  6, 5, 7,  9, 8, 10,  12, 11, 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Expected, SentData (508, sizeof (Expected)).data (), sizeof (Expected));
+
+    // the next frame starts from the one just sent
+    uint8_t NextInput[] = { 21, 22, 23 };
+    OutputMgr.WriteChannelData (512, sizeof (NextInput), NextInput);
+    OutputMgr.CommitFrame ();
+    TEST_ASSERT_TRUE (c_OutputMgrTest::TakeFrame ());
+
+    const uint8_t NextExpected[] = { 1, 2, 3, 4,  22, 21, 23,  9, 8, 10,  12, 11, 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (NextExpected, SentData (508, sizeof (NextExpected)).data (), sizeof (NextExpected));
+}
+
+//----------------------------------------------------------------------------
+void test_clear_leaves_the_sent_frame ()
+{
+    c_OutputMgrTest::Begin (512, 1100, "grb", true);
+
+    uint8_t Input[] = { 1, 2, 3, 4,  5, 6, 7 };
+    OutputMgr.WriteChannelData (508, sizeof (Input), Input);
+    OutputMgr.CommitFrame ();
+    TEST_ASSERT_TRUE (c_OutputMgrTest::TakeFrame ());
+
+    // the frame being sent is not touched until the cleared frame is taken
+    OutputMgr.ClearBuffer ();
+    const uint8_t Expected[] = { 1, 2, 3, 4,  6, 5, 7 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Expected, SentData (508, sizeof (Expected)).data (), sizeof (Expected));
+
+    TEST_ASSERT_TRUE (c_OutputMgrTest::TakeFrame ());
+    const uint8_t Cleared[sizeof (Expected)] = { 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (Cleared, SentData (508, sizeof (Cleared)).data (), sizeof (Cleared));
+}
+
+//----------------------------------------------------------------------------
+int main (int, char **)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_identity_routing);
+    RUN_TEST (test_overflow_routing);
+    RUN_TEST (test_double_buffered_overflow_routing);
+    RUN_TEST (test_clear_leaves_the_sent_frame);
+    return UNITY_END ();
+}